@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace flarksiesis
+{
+
+// Destructive interference size on every target we build for
+static constexpr std::size_t cacheLineSize = 64;
+
+//==============================================================================
+/**
+    Allocator that starts every block on a cache line and pads it to a whole
+    number of lines, so state written by one audio thread never shares a line
+    with another instance's, or with whatever the heap puts next to it.
+
+    Uses aligned operator new, like every new of a type with alignas members;
+    CMakeLists.txt sets the macOS deployment target to 10.14, the first one
+    that provides it.
+*/
+template <typename Type>
+struct CacheLineAllocator
+{
+    using value_type = Type;
+
+    CacheLineAllocator() noexcept = default;
+    template <typename Other> CacheLineAllocator(const CacheLineAllocator<Other>&) noexcept {}
+
+    Type* allocate(std::size_t count)
+    {
+        return static_cast<Type*>(::operator new(getPaddedSize(count), std::align_val_t(cacheLineSize)));
+    }
+
+    void deallocate(Type* block, std::size_t count) noexcept
+    {
+        ::operator delete(block, getPaddedSize(count), std::align_val_t(cacheLineSize));
+    }
+
+    static std::size_t getPaddedSize(std::size_t count) noexcept
+    {
+        return (count * sizeof(Type) + cacheLineSize - 1) / cacheLineSize * cacheLineSize;
+    }
+
+    template <typename Other> bool operator==(const CacheLineAllocator<Other>&) const noexcept { return true; }
+    template <typename Other> bool operator!=(const CacheLineAllocator<Other>&) const noexcept { return false; }
+};
+
+template <typename Type>
+using AlignedVector = std::vector<Type, CacheLineAllocator<Type>>;
+
+} // namespace flarksiesis
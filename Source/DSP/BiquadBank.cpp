@@ -0,0 +1,196 @@
+#include "BiquadBank.h"
+#include "CoefficientEngine.h"
+
+#include <algorithm>
+
+namespace flarksiesis
+{
+
+template <typename SampleType>
+void BiquadBank<SampleType>::prepare(int newNumChannels, int maxSamplesPerCall)
+{
+    numChannels = std::max(0, newNumChannels);
+    groups.resize(static_cast<size_t>((numChannels + lanes - 1) / lanes));
+    unusedLane.assign(static_cast<size_t>(std::max(maxSamplesPerCall, lanes)), SampleType(0));
+    reset();
+}
+
+template <typename SampleType>
+void BiquadBank<SampleType>::reset() noexcept
+{
+    for (auto& group : groups)
+    {
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            group.s1[lane] = group.s2[lane] = SampleType(0);
+            group.b0[lane] = group.tb0[lane] = SampleType(1);
+            group.b1[lane] = group.b2[lane] = group.a1[lane] = group.a2[lane] = SampleType(0);
+            group.tb1[lane] = group.tb2[lane] = group.ta1[lane] = group.ta2[lane] = SampleType(0);
+            group.hasCoefficients[lane] = false;
+        }
+    }
+
+    std::fill(unusedLane.begin(), unusedLane.end(), SampleType(0));
+    kernel = kernels->biquad[genericResponse];
+    rampRemaining = 0;
+}
+
+template <typename SampleType>
+void BiquadBank<SampleType>::setTarget(int channel, const BiquadCoefficients& target) noexcept
+{
+    auto& group = groups[static_cast<size_t>(channel / lanes)];
+    const int lane = channel % lanes;
+
+    group.tb0[lane] = static_cast<SampleType>(target.b0);
+    group.tb1[lane] = static_cast<SampleType>(target.b1);
+    group.tb2[lane] = static_cast<SampleType>(target.b2);
+    group.ta1[lane] = static_cast<SampleType>(target.a1);
+    group.ta2[lane] = static_cast<SampleType>(target.a2);
+
+    if (! group.hasCoefficients[lane])
+    {
+        group.b0[lane] = group.tb0[lane];
+        group.b1[lane] = group.tb1[lane];
+        group.b2[lane] = group.tb2[lane];
+        group.a1[lane] = group.ta1[lane];
+        group.a2[lane] = group.ta2[lane];
+        group.hasCoefficients[lane] = true;
+    }
+}
+
+template <typename SampleType>
+void BiquadBank<SampleType>::setFilterType(int filterType) noexcept
+{
+    const auto newResponse = getFilterResponse(filterType);
+
+    if (newResponse != response)
+    {
+        response = newResponse;
+        kernel = kernels->biquad[genericResponse];
+    }
+}
+
+template <typename SampleType>
+void BiquadBank<SampleType>::resolveLanes(int groupIndex, SampleType* const* channels, int startSample,
+                                          SampleType* (&lanePointers)[lanes]) noexcept
+{
+    for (int lane = 0; lane < lanes; ++lane)
+    {
+        const int channel = groupIndex * lanes + lane;
+        lanePointers[lane] = channel < numChannels ? channels[channel] + startSample
+                                                   : unusedLane.data();
+    }
+}
+
+template <typename SampleType>
+void BiquadBank<SampleType>::startRamp(int rampSamples) noexcept
+{
+    rampRemaining = std::max(1, rampSamples);
+    const SampleType step = SampleType(1) / static_cast<SampleType>(rampRemaining);
+
+    for (auto& group : groups)
+    {
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            group.db0[lane] = (group.tb0[lane] - group.b0[lane]) * step;
+            group.db1[lane] = (group.tb1[lane] - group.b1[lane]) * step;
+            group.db2[lane] = (group.tb2[lane] - group.b2[lane]) * step;
+            group.da1[lane] = (group.ta1[lane] - group.a1[lane]) * step;
+            group.da2[lane] = (group.ta2[lane] - group.a2[lane]) * step;
+        }
+    }
+}
+
+template <typename SampleType>
+void BiquadBank<SampleType>::landOnTargets() noexcept
+{
+    // Exactly, so rounding in the ramps never accumulates
+    for (auto& group : groups)
+    {
+        std::copy(group.tb0, group.tb0 + lanes, group.b0);
+        std::copy(group.tb1, group.tb1 + lanes, group.b1);
+        std::copy(group.tb2, group.tb2 + lanes, group.b2);
+        std::copy(group.ta1, group.ta1 + lanes, group.a1);
+        std::copy(group.ta2, group.ta2 + lanes, group.a2);
+    }
+
+    // Every lane is on a design of the targets' response
+    kernel = kernels->biquad[response];
+}
+
+template <typename SampleType>
+void BiquadBank<SampleType>::process(SampleType* const* channels, int startSample, int numSamples) noexcept
+{
+    for (int done = 0; done < numSamples;)
+    {
+        // Past the end of a ramp, the next runs on the targets
+        if (rampRemaining <= 0)
+            startRamp(numSamples - done);
+
+        const int length = std::min(numSamples - done, rampRemaining);
+
+        for (size_t g = 0; g < groups.size(); ++g)
+        {
+            SampleType* lane[lanes];
+            resolveLanes(static_cast<int>(g), channels, startSample + done, lane);
+            kernel(groups[g], lane, length);
+        }
+
+        done += length;
+
+        if ((rampRemaining -= length) == 0)
+            landOnTargets();
+    }
+}
+
+template <typename SampleType>
+void BiquadBank<SampleType>::processReference(SampleType* const* channels, int startSample, int numSamples) noexcept
+{
+    for (int done = 0; done < numSamples;)
+    {
+        if (rampRemaining <= 0)
+            startRamp(numSamples - done);
+
+        const int length = std::min(numSamples - done, rampRemaining);
+
+        for (size_t g = 0; g < groups.size(); ++g)
+        {
+            auto& group = groups[g];
+
+            for (int l = 0; l < lanes; ++l)
+            {
+                const int channel = static_cast<int>(g) * lanes + l;
+
+                if (channel >= numChannels)
+                    break;
+
+                BiquadState<SampleType> state;
+                state.z = {group.s1[l], group.s2[l]};
+
+                // The lanes hold SampleType values, which double holds exactly, so the reference
+                // takes the same steps from the same coefficients
+                BiquadCoefficients current {group.b0[l], group.b1[l], group.b2[l], group.a1[l], group.a2[l]};
+                const BiquadCoefficients step {group.db0[l], group.db1[l], group.db2[l], group.da1[l], group.da2[l]};
+
+                CoefficientEngine::processStepped(channels[channel] + startSample + done, length, state, current, step);
+
+                group.s1[l] = state.z[0]; group.s2[l] = state.z[1];
+                group.b0[l] = static_cast<SampleType>(current.b0);
+                group.b1[l] = static_cast<SampleType>(current.b1);
+                group.b2[l] = static_cast<SampleType>(current.b2);
+                group.a1[l] = static_cast<SampleType>(current.a1);
+                group.a2[l] = static_cast<SampleType>(current.a2);
+            }
+        }
+
+        done += length;
+
+        if ((rampRemaining -= length) == 0)
+            landOnTargets();
+    }
+}
+
+template class BiquadBank<float>;
+template class BiquadBank<double>;
+
+} // namespace flarksiesis
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "AlignedVector.h"
+#include "FilterCoefficients.h"
+#include "Kernels.h"
+
+namespace flarksiesis
+{
+
+//==============================================================================
+/**
+    Delta-operator biquads (see BiquadCoefficients) for several channels, stored
+    channel-interleaved (structure of arrays) so that one SIMD register holds
+    the same state variable for four channels. Stereo runs as a single group.
+
+    SampleType is float or double: state, ramps and arithmetic are all in that
+    type. The designs are double; setTarget() rounds them to SampleType once,
+    and a ramp always ends exactly on that rounded design.
+
+    Each channel gets its own coefficient target per sub-block; process() ramps
+    every lane from its current coefficients to that target, exactly like
+    CoefficientEngine::processRamped(), which stays the scalar reference.
+    processReference() runs that scalar path on the same state. A ramp started
+    with startRamp() may be split across any number of process() calls, so a
+    sub-block keeps its length however the host splits the stream.
+
+    The loop is a kernel (see Kernels.h), instantiated once per FilterResponse
+    and instruction set, and setFilterType() picks one from the set the CPU
+    runs, once per block. A shaped kernel ramps only the coefficients its
+    response leaves free (two to four of the five) and derives the rest,
+    dropping the terms the response zeroes.
+
+    Tolerance: every kernel, baseline or AVX2, performs the same operations in
+    the same order as the reference (less the terms a response zeroes), so the
+    outputs are the same unless the compiler contracts the scalar code into
+    FMAs (e.g. -march=native). Then the two differ by rounding only, measured
+    at under 2e-6 of the signal peak for resonance up to 8 on all eight filter
+    types.
+*/
+template <typename SampleType>
+class BiquadBank
+{
+public:
+    static constexpr int lanes = 4;
+
+    // Allocates state for numChannels; maxSamplesPerCall bounds numSamples in process()
+    void prepare(int numChannels, int maxSamplesPerCall);
+    void reset() noexcept;
+
+    int getNumChannels() const noexcept { return numChannels; }
+
+    // Coefficients this channel should reach at the end of the next ramp.
+    // The first target after reset() is applied immediately instead of ramped.
+    void setTarget(int channel, const BiquadCoefficients& target) noexcept;
+
+    // Ramps to the targets over the next rampSamples samples, however process() calls split
+    // them: the steps are fixed here, after the targets are set. Samples past the end of the
+    // ramp run on the targets. Without a ramp in progress, process() ramps over its own call.
+    void startRamp(int rampSamples) noexcept;
+
+    // The "filtertype" every target is designed for, which picks the kernel process() runs.
+    // After reset() and a change of response, the generic kernel runs while the
+    // coefficients ramp onto the new designs; that kernel takes any coefficients, and so
+    // it is also what runs until this is first called.
+    void setFilterType(int filterType) noexcept;
+
+    void process(SampleType* const* channels, int startSample, int numSamples) noexcept;
+    void processReference(SampleType* const* channels, int startSample, int numSamples) noexcept;
+
+private:
+    using Group = BiquadLanes<SampleType>;
+    using Kernel = typename SampleKernels<SampleType>::BiquadKernel;
+
+    AlignedVector<Group> groups;
+    AlignedVector<SampleType> unusedLane; // Input/output for lanes past the last channel
+    int numChannels = 0;
+
+    const SampleKernels<SampleType>* kernels = &getKernels().forSampleType<SampleType>();
+    FilterResponse response = genericResponse;       // Of the targets
+    Kernel kernel = kernels->biquad[genericResponse]; // For the current coefficients
+    int rampRemaining = 0;                            // Samples left in the ramp to the targets
+
+    void resolveLanes(int groupIndex, SampleType* const* channels, int startSample,
+                      SampleType* (&lanePointers)[lanes]) noexcept;
+    void landOnTargets() noexcept;
+};
+
+} // namespace flarksiesis
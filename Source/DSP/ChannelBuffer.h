@@ -0,0 +1,49 @@
+#pragma once
+
+#include "AlignedVector.h"
+
+#include <algorithm>
+
+namespace flarksiesis
+{
+
+//==============================================================================
+/**
+    A fixed number of channels of samples, in one allocation, with every
+    channel starting on its own cache line. setSize() is the only call that
+    allocates; a size of zero frees the storage.
+*/
+template <typename SampleType>
+class ChannelBuffer
+{
+public:
+    void setSize(int newNumChannels, int newNumSamples)
+    {
+        numChannels = std::max(0, newNumChannels);
+        numSamples = std::max(0, newNumSamples);
+
+        constexpr int samplesPerLine = static_cast<int>(cacheLineSize / sizeof(SampleType));
+        stride = (numSamples + samplesPerLine - 1) / samplesPerLine * samplesPerLine;
+
+        storage.assign(static_cast<size_t>(numChannels) * static_cast<size_t>(stride), SampleType(0));
+
+        if (numChannels * numSamples == 0)
+            storage.shrink_to_fit();
+    }
+
+    void clear() noexcept { std::fill(storage.begin(), storage.end(), SampleType(0)); }
+
+    int getNumChannels() const noexcept { return numChannels; }
+    int getNumSamples() const noexcept { return numSamples; }
+
+    SampleType* getChannel(int channel) noexcept             { return storage.data() + channel * stride; }
+    const SampleType* getChannel(int channel) const noexcept { return storage.data() + channel * stride; }
+
+private:
+    AlignedVector<SampleType> storage;
+    int numChannels = 0;
+    int numSamples = 0;
+    int stride = 0;
+};
+
+} // namespace flarksiesis
@@ -0,0 +1,79 @@
+#include "CoefficientEngine.h"
+
+#include <algorithm>
+
+namespace flarksiesis
+{
+
+void CoefficientEngine::prepare(double newSampleRate, int newControlInterval)
+{
+    sampleRate = newSampleRate;
+    controlInterval = std::clamp(newControlInterval, 1, maxControlInterval);
+
+    if (table == nullptr || table->getSampleRate() != sampleRate)
+        table = CoefficientTable::getShared(sampleRate);
+}
+
+void CoefficientEngine::release()
+{
+    table.reset();
+}
+
+template <typename SampleType>
+void CoefficientEngine::processRamped(SampleType* samples, int numSamples, BiquadState<SampleType>& state,
+                                      BiquadCoefficients& current, const BiquadCoefficients& target) noexcept
+{
+    using T = SampleType;
+
+    if (numSamples <= 0)
+        return;
+
+    // Steps in SampleType, which double holds exactly
+    const T step = T(1) / static_cast<T>(numSamples);
+    const BiquadCoefficients steps { (T(target.b0) - T(current.b0)) * step, (T(target.b1) - T(current.b1)) * step,
+                                     (T(target.b2) - T(current.b2)) * step, (T(target.a1) - T(current.a1)) * step,
+                                     (T(target.a2) - T(current.a2)) * step };
+
+    processStepped(samples, numSamples, state, current, steps);
+    current = target;
+}
+
+template <typename SampleType>
+void CoefficientEngine::processStepped(SampleType* samples, int numSamples, BiquadState<SampleType>& state,
+                                       BiquadCoefficients& current, const BiquadCoefficients& step) noexcept
+{
+    using T = SampleType;
+
+    T b0 = T(current.b0), b1 = T(current.b1), b2 = T(current.b2);
+    T a1 = T(current.a1), a2 = T(current.a2);
+
+    const T db0 = T(step.b0), db1 = T(step.b1), db2 = T(step.b2);
+    const T da1 = T(step.a1), da2 = T(step.a2);
+
+    T s1 = state.z[0], s2 = state.z[1];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        b0 += db0; b1 += db1; b2 += db2;
+        a1 += da1; a2 += da2;
+
+        const T input = samples[i];
+        const T output = b0 * input + s1;
+
+        // Both integrators take this sample's output, so update them from the old s2
+        s1 = (s1 + (b1 * input + s2)) - a1 * output;
+        s2 = (s2 + b2 * input) - a2 * output;
+
+        samples[i] = output;
+    }
+
+    state.z = {s1, s2};
+    current = {b0, b1, b2, a1, a2};
+}
+
+template void CoefficientEngine::processRamped(float*, int, BiquadState<float>&, BiquadCoefficients&, const BiquadCoefficients&) noexcept;
+template void CoefficientEngine::processRamped(double*, int, BiquadState<double>&, BiquadCoefficients&, const BiquadCoefficients&) noexcept;
+template void CoefficientEngine::processStepped(float*, int, BiquadState<float>&, BiquadCoefficients&, const BiquadCoefficients&) noexcept;
+template void CoefficientEngine::processStepped(double*, int, BiquadState<double>&, BiquadCoefficients&, const BiquadCoefficients&) noexcept;
+
+} // namespace flarksiesis
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoefficientTable.h"
+
+namespace flarksiesis
+{
+
+//==============================================================================
+/**
+    Designs biquad coefficients at a control rate instead of once per sample.
+
+    The caller splits the stream into sub-blocks of getControlInterval() samples,
+    designs the coefficients for each one from the control values at its start
+    and runs the sub-block through processRamped(), which interpolates linearly
+    from the previous design to that one (processStepped() when the sub-block
+    is split across calls). The (a1, a2) stability triangle is convex (in the delta
+    form too, which maps it affinely), so every intermediate coefficient set of
+    a ramp between two stable designs is stable.
+
+    prepare() attaches the process-wide CoefficientTable for the sample rate, so
+    design() is a table read rather than a trig evaluation.
+*/
+class CoefficientEngine
+{
+public:
+    static constexpr int defaultControlInterval = 16;
+    static constexpr int maxControlInterval = 256;
+
+    void prepare(double sampleRate, int controlInterval);
+    void release();
+
+    int getControlInterval() const noexcept { return controlInterval; }
+    double getSampleRate() const noexcept { return sampleRate; }
+
+    BiquadCoefficients design(int filterType, float frequency, float resonance) const noexcept
+    {
+        return table != nullptr ? table->lookup(filterType, frequency, resonance)
+                                : designBiquad(filterType, frequency, resonance, sampleRate);
+    }
+
+    const CoefficientTable* getTable() const noexcept { return table.get(); }
+
+    // Filters numSamples in place. The coefficients move from 'current' to 'target'
+    // over the sub-block (the last sample uses 'target') and 'current' is left at 'target'.
+    // The ramp and the filter run in SampleType, float or double, so the float path rounds
+    // the designs to float first. The filter is a delta-operator transposed direct form II:
+    // the delays of the usual one are integrators, and its state stays well scaled however
+    // low the cutoff is against the sample rate.
+    template <typename SampleType>
+    static void processRamped(SampleType* samples, int numSamples, BiquadState<SampleType>& state,
+                              BiquadCoefficients& current, const BiquadCoefficients& target) noexcept;
+
+    // The loop under processRamped(): filters numSamples in place, adding 'step' to the
+    // coefficients before each sample, and leaves 'current' where that got to. A ramp split
+    // across calls takes the same steps as one that isn't.
+    template <typename SampleType>
+    static void processStepped(SampleType* samples, int numSamples, BiquadState<SampleType>& state,
+                               BiquadCoefficients& current, const BiquadCoefficients& step) noexcept;
+
+private:
+    double sampleRate = 44100.0;
+    int controlInterval = defaultControlInterval;
+    std::shared_ptr<const CoefficientTable> table;
+};
+
+} // namespace flarksiesis
@@ -0,0 +1,101 @@
+#include "CoefficientTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+namespace flarksiesis
+{
+
+CoefficientTable::CoefficientTable(double newSampleRate)
+    : sampleRate(newSampleRate)
+{
+    // Keep the top of the grid below Nyquist for low sample rates
+    const float topFrequency = std::min(maxFrequency, static_cast<float>(0.49 * sampleRate));
+
+    log2MinFrequency = std::log2(minFrequency);
+    frequencyPointsPerOctave = static_cast<float>(numFrequencyPoints - 1)
+                             / (std::log2(topFrequency) - log2MinFrequency);
+
+    log2MinResonance = std::log2(minResonance);
+    resonancePointsPerOctave = static_cast<float>(numResonancePoints - 1)
+                             / (std::log2(maxResonance) - log2MinResonance);
+
+    inverseResonance.resize(numResonancePoints);
+    entries.resize(static_cast<size_t>(numFilterTypes) * numResonancePoints * numFrequencyPoints);
+
+    auto* entry = entries.data();
+
+    for (int type = 0; type < numFilterTypes; ++type)
+    {
+        for (int r = 0; r < numResonancePoints; ++r)
+        {
+            const float resonance = std::exp2(log2MinResonance + static_cast<float>(r) / resonancePointsPerOctave);
+            inverseResonance[static_cast<size_t>(r)] = 1.0f / resonance;
+
+            for (int f = 0; f < numFrequencyPoints; ++f)
+            {
+                const float frequency = std::exp2(log2MinFrequency + static_cast<float>(f) / frequencyPointsPerOctave);
+                *entry++ = designBiquad(type, frequency, resonance, sampleRate);
+            }
+        }
+    }
+}
+
+std::shared_ptr<const CoefficientTable> CoefficientTable::getShared(double sampleRate)
+{
+    static std::mutex registryLock;
+    static std::map<long long, std::weak_ptr<const CoefficientTable>> registry;
+
+    const auto key = std::llround(sampleRate * 1000.0);
+
+    std::lock_guard<std::mutex> lock(registryLock);
+
+    auto& slot = registry[key];
+
+    if (auto existing = slot.lock())
+        return existing;
+
+    auto table = std::make_shared<const CoefficientTable>(sampleRate);
+    slot = table;
+    return table;
+}
+
+BiquadCoefficients CoefficientTable::lookup(int filterType, float frequency, float resonance) const noexcept
+{
+    filterType = std::clamp(filterType, 0, numFilterTypes - 1);
+
+    float fPos = (std::log2(frequency) - log2MinFrequency) * frequencyPointsPerOctave;
+    fPos = std::clamp(fPos, 0.0f, static_cast<float>(numFrequencyPoints - 1));
+    const int f = std::min(static_cast<int>(fPos), numFrequencyPoints - 2);
+    const float fFrac = fPos - static_cast<float>(f);
+
+    float rPos = (std::log2(resonance) - log2MinResonance) * resonancePointsPerOctave;
+    rPos = std::clamp(rPos, 0.0f, static_cast<float>(numResonancePoints - 1));
+    const int r = std::min(static_cast<int>(rPos), numResonancePoints - 2);
+    const float r0 = inverseResonance[static_cast<size_t>(r)];
+    const float r1 = inverseResonance[static_cast<size_t>(r) + 1];
+    const float rFrac = std::clamp((1.0f / resonance - r0) / (r1 - r0), 0.0f, 1.0f);
+
+    const auto* row0 = entries.data()
+                     + (static_cast<size_t>(filterType) * numResonancePoints + static_cast<size_t>(r)) * numFrequencyPoints
+                     + static_cast<size_t>(f);
+    const auto* row1 = row0 + numFrequencyPoints;
+
+    const double fWeight = fFrac, rWeight = rFrac;
+    const double w00 = (1.0 - fWeight) * (1.0 - rWeight);
+    const double w01 = fWeight * (1.0 - rWeight);
+    const double w10 = (1.0 - fWeight) * rWeight;
+    const double w11 = fWeight * rWeight;
+
+    BiquadCoefficients c;
+    c.b0 = w00 * row0[0].b0 + w01 * row0[1].b0 + w10 * row1[0].b0 + w11 * row1[1].b0;
+    c.b1 = w00 * row0[0].b1 + w01 * row0[1].b1 + w10 * row1[0].b1 + w11 * row1[1].b1;
+    c.b2 = w00 * row0[0].b2 + w01 * row0[1].b2 + w10 * row1[0].b2 + w11 * row1[1].b2;
+    c.a1 = w00 * row0[0].a1 + w01 * row0[1].a1 + w10 * row1[0].a1 + w11 * row1[1].a1;
+    c.a2 = w00 * row0[0].a2 + w01 * row0[1].a2 + w10 * row1[0].a2 + w11 * row1[1].a2;
+    return c;
+}
+
+} // namespace flarksiesis
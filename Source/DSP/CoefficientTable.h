@@ -0,0 +1,70 @@
+#pragma once
+
+#include "FilterCoefficients.h"
+
+#include <memory>
+#include <vector>
+
+namespace flarksiesis
+{
+
+//==============================================================================
+/**
+    Precomputed biquad coefficients for all eight filter types over a
+    log-frequency x log-resonance grid, read back with bilinear interpolation
+    (linear in log-frequency, and linear in 1/resonance between grid points).
+    Entries and interpolation are in double, like designBiquad(). Interpolating
+    keeps the relations between a response's coefficients (see FilterResponse)
+    exact: they are equalities, zeros and power-of-two multiples.
+
+    From 44.1 kHz up, a lookup's magnitude response is within 0.12 dB of
+    designBiquad()'s wherever that response is above -20 dB, within 0.2 dB on
+    the notch's skirts, and the allpass's phase is within 3 degrees (checked by
+    Tests/CoefficientTable). Both worst cases are a resonant cutoff just under
+    20 kHz at 44.1 kHz, where the bilinear transform crowds the response
+    against Nyquist; a 16-point resonance grid allowed 0.17 dB at low
+    resonance, and 320 frequency points 0.38 dB near the top.
+
+    A table only depends on the sample rate, so it is immutable once built and
+    getShared() hands the same instance to every plugin instance in the process.
+    It takes 6.5 MB, of which a lookup reads four entries.
+*/
+class CoefficientTable
+{
+public:
+    static constexpr int numFilterTypes = 8;
+    static constexpr int numFrequencyPoints = 640;
+    static constexpr int numResonancePoints = 32;
+
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float maxFrequency = 20000.0f;
+    static constexpr float minResonance = 0.1f;
+    static constexpr float maxResonance = 10.0f;
+
+    explicit CoefficientTable(double sampleRate);
+
+    CoefficientTable(const CoefficientTable&) = delete;
+    CoefficientTable& operator=(const CoefficientTable&) = delete;
+
+    // Returns the process-wide table for this sample rate, building it if no
+    // instance currently holds one. Locks and allocates: call from prepareToPlay().
+    static std::shared_ptr<const CoefficientTable> getShared(double sampleRate);
+
+    BiquadCoefficients lookup(int filterType, float frequency, float resonance) const noexcept;
+
+    double getSampleRate() const noexcept { return sampleRate; }
+    size_t getMemorySize() const noexcept { return entries.size() * sizeof(BiquadCoefficients); }
+
+private:
+    double sampleRate;
+    float log2MinFrequency, frequencyPointsPerOctave;
+    float log2MinResonance, resonancePointsPerOctave;
+
+    // 1 / resonance at each grid point; the coefficients are close to linear in it
+    std::vector<float> inverseResonance;
+
+    // Laid out as [filterType][resonance][frequency]
+    std::vector<BiquadCoefficients> entries;
+};
+
+} // namespace flarksiesis
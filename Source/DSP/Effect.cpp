@@ -0,0 +1,786 @@
+#include "Effect.h"
+#include "ModulationMapper.h"
+#include "NoDenormals.h"
+#include "OutputStage.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace flarksiesis
+{
+
+namespace
+{
+
+// To nearest, ties to even, as juce::roundToInt() rounds
+int roundToInt(double value) noexcept
+{
+    return static_cast<int>(std::lrint(value));
+}
+
+} // namespace
+
+//==============================================================================
+template <typename SampleType>
+void Effect::SignalPath<SampleType>::prepare(int numChannels, int samplesPerBlock, int crossfadeSamples)
+{
+    dryBuffer.setSize(std::max(1, numChannels), std::max(1, samplesPerBlock));
+
+    // Reset filter states; oversampled sub-blocks are up to maxFactor times longer
+    filterBank.prepare(numChannels, CoefficientEngine::maxControlInterval * Oversampler<SampleType>::maxFactor);
+    svfBank.prepare(numChannels, CoefficientEngine::maxControlInterval * Oversampler<SampleType>::maxFactor);
+
+    // Oversampling buffers and the matching dry delay are sized for the largest factor; the delay
+    // line has one more sample than the longest latency, as the input is written before the tap is read
+    oversampler.prepare(numChannels, std::max(1, samplesPerBlock));
+    dryDelay.setSize(std::max(1, numChannels), Oversampler<SampleType>::getLatencySamples(Oversampler<SampleType>::maxFactor) + 1);
+    dryCrossfadeLength = std::max(1, crossfadeSamples);
+    lastWetSamples.assign(static_cast<size_t>(std::max(1, numChannels)), SampleType(0));
+    reset();
+}
+
+template <typename SampleType>
+void Effect::SignalPath<SampleType>::release()
+{
+    // An empty dry buffer marks the path as unprepared; process() then leaves the audio alone
+    dryBuffer.setSize(0, 0);
+    dryDelay.setSize(0, 0);
+    filterBank.prepare(0, 0);
+    svfBank.prepare(0, 0);
+    oversampler.prepare(1, 1);
+    dryDelayPosition = 0;
+    dryCrossfadeRemaining = 0;
+    lastWetSamples.clear();
+}
+
+template <typename SampleType>
+void Effect::SignalPath<SampleType>::reset() noexcept
+{
+    resetFilters();
+    oversampler.reset();
+    dryDelay.clear();
+    dryDelayPosition = 0;
+    dryCrossfadeRemaining = 0;
+    std::fill(lastWetSamples.begin(), lastWetSamples.end(), SampleType(0));
+}
+
+template <typename SampleType>
+void Effect::SignalPath<SampleType>::resetFilters() noexcept
+{
+    filterBank.reset();
+    svfBank.reset();
+}
+
+template <typename SampleType>
+void Effect::SignalPath<SampleType>::setOversamplingFactor(int factor) noexcept
+{
+    // Everything was allocated in prepare(), so switching is safe on the audio thread. The wet
+    // state starts clear; the dry signal moves to the new delay over dryCrossfadeLength samples.
+    const int previousDelay = oversampler.getLatencySamples();
+    oversampler.setFactor(factor);
+    resetFilters();
+    std::fill(lastWetSamples.begin(), lastWetSamples.end(), SampleType(0));
+
+    if (oversampler.getLatencySamples() != previousDelay)
+    {
+        dryCrossfadeFromDelay = previousDelay;
+        dryCrossfadeRemaining = dryCrossfadeLength;
+    }
+}
+
+template <>
+Effect::SignalPath<float>& Effect::getSignalPath<float>() noexcept
+{
+    return floatPath;
+}
+
+template <>
+Effect::SignalPath<double>& Effect::getSignalPath<double>() noexcept
+{
+    return doublePath;
+}
+
+//==============================================================================
+void Effect::prepare(double sampleRate, int numChannels, int maxFramesPerCall, bool doublePrecision)
+{
+    const int maxFrames = std::max(1, maxFramesPerCall);
+
+    currentSampleRate = sampleRate;
+    numPreparedChannels = numChannels;
+    telemetryInterval = std::max(1, roundToInt(sampleRate / telemetryRateHz));
+    telemetryCountdown = 0;
+    idle = false;
+    quietSamples = 0;
+    skippedBlocks.store(0);
+
+    // Attaches the shared coefficient tables for this rate and its oversampled rates, building them on first use
+    for (int mode = 0; mode < numOversamplingModes; ++mode)
+        coefficientEngines[static_cast<size_t>(mode)].prepare(sampleRate * (1 << mode), controlInterval);
+
+    // Scratch storage for the longest chunk; process() never allocates
+    parameterRamps.setSize(numRamps, maxFrames);
+
+    // Start the ramps at the current values so playback doesn't begin with a sweep
+    const auto& params = nextParameters;
+    lastParameters = params;
+    programChanged = false;
+    switchFadeSamples = 0;
+
+    const std::array<float, numLinearRamps> initialValues {params.depth, params.resonance, params.mix,
+                                                           params.stereoWidth, params.feedback};
+
+    for (size_t i = 0; i < smoothers.size(); ++i)
+    {
+        smoothers[i].reset(sampleRate, rampLengthSeconds);
+        smoothers[i].setCurrentAndTargetValue(initialValues[i]);
+    }
+
+    frequencySmoother.reset(sampleRate, rampLengthSeconds);
+    frequencySmoother.setCurrentAndTargetValue(params.frequency);
+    structureFade.reset(sampleRate, rampLengthSeconds);
+    structureFade.setCurrentAndTargetValue(1.0f);
+
+    const int interval = coefficientEngines[0].getControlInterval();
+    parameterGrid = std::max(interval, parameterReadInterval / interval * interval);
+    gridPosition = 0;
+
+    // Audio buffers, filter state and oversampling in the precision that will be processed. The
+    // factor is set first, so preparing the path clears the dry delay with no crossfade pending.
+    activeFilterEngine = params.filterEngine;
+    setOversamplingMode(params.oversampling);
+    const int crossfadeSamples = roundToInt(rampLengthSeconds * sampleRate);
+
+    if (doublePrecision)
+    {
+        doublePath.prepare(numChannels, maxFrames, crossfadeSamples);
+        floatPath.release();
+    }
+    else
+    {
+        floatPath.prepare(numChannels, maxFrames, crossfadeSamples);
+        doublePath.release();
+    }
+
+    // Reset LFO; a chunk has at most one control point per sample
+    lfo.prepare(numChannels, maxFrames);
+    lfoPhaseOffsets.assign(static_cast<size_t>(maxFrames), 0.0f);
+    pointDepths.assign(static_cast<size_t>(maxFrames), 0.0f);
+    pointFrequencies.assign(static_cast<size_t>(maxFrames), 0.0f);
+    pointResonances.assign(static_cast<size_t>(maxFrames), 0.0f);
+    lfoBank.prepare(maxFrames);
+    modulationMatrix.prepare(maxFrames);
+    pointCutoffs.setSize(std::max(1, numChannels), maxFrames);
+    smoothedCutoffs.assign(static_cast<size_t>(std::max(1, numChannels)), params.frequency);
+}
+
+void Effect::release()
+{
+    for (auto& engine : coefficientEngines)
+        engine.release();
+
+    floatPath.release();
+    doublePath.release();
+    parameterRamps.setSize(0, 0);
+}
+
+//==============================================================================
+void Effect::setParameters(const Parameters& newParameters) noexcept
+{
+    // The choices that index into arrays here are brought into range
+    nextParameters = newParameters;
+    nextParameters.oversampling = std::clamp(newParameters.oversampling, 0, numOversamplingModes - 1);
+    nextParameters.filterEngine = newParameters.filterEngine == svfEngine ? svfEngine : biquadEngine;
+}
+
+void Effect::changeProgram(const Parameters& newParameters) noexcept
+{
+    setParameters(newParameters);
+    programChanged = true;
+}
+
+double Effect::getTailLengthSeconds(const Parameters& params) const noexcept
+{
+    // Time for the slowest filter pole to decay from full scale to the silence threshold. The cutoff
+    // is at its lowest with the LFO at -1; below Q = 0.5 the poles are real and the slower one sets the rate.
+    // Modulation matrix routes widen the ranges of cutoff, resonance and feedback by their summed depths.
+    std::array<double, ModulationMatrix::numTargets> reach {};
+
+    for (const auto& route : params.routes)
+        if (route.target >= 0 && route.target < static_cast<int>(ModulationMatrix::numTargets))
+            reach[static_cast<size_t>(route.target)] += std::abs(route.depth);
+
+    const double octavesDown = (params.depth + reach[ModulationMatrix::cutoff]) * ModulationMapper::octavesAtFullDepth;
+    const double lowestCutoff = std::max(static_cast<double>(ModulationMapper::minCutoff),
+                                         params.frequency * std::exp2(-octavesDown));
+
+    auto decayRateAt = [lowestCutoff](double q)
+    {
+        constexpr double twoPi = 6.283185307179586476925286766559;
+        const double halfBandwidth = 1.0 / (2.0 * std::clamp(q, 0.1, 10.0));
+        return twoPi * lowestCutoff * (halfBandwidth - std::sqrt(std::max(0.0, halfBandwidth * halfBandwidth - 1.0)));
+    };
+
+    // The decay is slowest at one end of the resonance range
+    const double resonanceSpread = std::exp2(reach[ModulationMatrix::resonance] * resonanceOctavesAtFullDepth);
+    const double decayRate = std::min(decayRateAt(params.resonance / resonanceSpread),
+                                      decayRateAt(params.resonance * resonanceSpread));
+    const float feedback = std::min(0.95f, params.feedback + 0.95f * static_cast<float>(reach[ModulationMatrix::feedback]));
+    const double nepersToSilence = -std::log(static_cast<double>(silenceThreshold)); // Natural log: decay rates are in nepers
+
+    // Feedback is a one-pole recursion with the feedback amount as its pole
+    const double feedbackSamples = feedback > 0.0f ? nepersToSilence / -std::log(static_cast<double>(feedback)) : 0.0;
+
+    return nepersToSilence / decayRate
+         + (feedbackSamples + Oversampler<float>::getLatencySamples(1 << std::clamp(params.oversampling, 0, numOversamplingModes - 1)))
+               / currentSampleRate;
+}
+
+void Effect::setOversamplingMode(int mode) noexcept
+{
+    oversamplingMode = mode;
+    floatPath.setOversamplingFactor(1 << mode);
+    doublePath.setOversamplingFactor(1 << mode);
+    latency.store(Oversampler<float>::getLatencySamples(1 << mode));
+}
+
+void Effect::resetFilters() noexcept
+{
+    floatPath.resetFilters();
+    doublePath.resetFilters();
+}
+
+template <typename SampleType>
+void Effect::delayDrySignal(SignalPath<SampleType>& path, int numChannels, int numSamples) noexcept
+{
+    // Keeps the dry signal in line with the oversampled (and therefore delayed) wet signal. The
+    // line is written at every factor, so it has history for whichever delay comes next.
+    const int length = path.dryDelay.getNumSamples();
+    const int delay = path.oversampler.getLatencySamples();
+    const int fromDelay = path.dryCrossfadeFromDelay;
+    const auto fadeStep = SampleType(1) / static_cast<SampleType>(path.dryCrossfadeLength);
+
+    int position = path.dryDelayPosition;
+    int remaining = path.dryCrossfadeRemaining;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* dry = path.dryBuffer.getChannel(channel);
+        auto* line = path.dryDelay.getChannel(channel);
+        position = path.dryDelayPosition;
+        remaining = path.dryCrossfadeRemaining;
+
+        auto tap = [line, length](int writePosition, int samplesBack)
+        {
+            const int index = writePosition - samplesBack;
+            return line[index < 0 ? index + length : index];
+        };
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            line[position] = dry[sample];
+            auto delayed = tap(position, delay);
+
+            // From all old delay to all new, one step per sample
+            if (remaining > 0)
+            {
+                delayed += (tap(position, fromDelay) - delayed) * (static_cast<SampleType>(remaining) * fadeStep);
+                --remaining;
+            }
+
+            dry[sample] = delayed;
+
+            if (++position == length)
+                position = 0;
+        }
+    }
+
+    path.dryDelayPosition = position;
+    path.dryCrossfadeRemaining = remaining;
+}
+
+float Effect::getEffectiveRate(float rateParam, bool tempoSync) const noexcept
+{
+    if (! tempoSync || tempo <= 0.0)
+        return rateParam;
+
+    // Map rate parameter to musical divisions
+    const float division = std::pow(2.0f, std::floor(rateParam * 4.0f - 8.0f));
+    return static_cast<float>((tempo / 60.0) * division);
+}
+
+//==============================================================================
+void Effect::process(float* const* channels, int numChannels, int numFrames) noexcept
+{
+    processSamples(channels, numChannels, numFrames);
+}
+
+void Effect::process(double* const* channels, int numChannels, int numFrames) noexcept
+{
+    processSamples(channels, numChannels, numFrames);
+}
+
+template <typename SampleType>
+void Effect::processSamples(SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    const ScopedNoDenormals noDenormals;
+
+    // Not prepared yet, or prepared for the other precision or another channel count
+    auto& path = getSignalPath<SampleType>();
+
+    if (numSamples <= 0 || numChannels <= 0 || numChannels != numPreparedChannels || path.dryBuffer.getNumSamples() == 0)
+        return;
+
+    // Silent input: carry on until the tail has decayed, then skip calls until input returns
+    const bool inputSilent = isInputSilent(channels, numChannels, numSamples);
+
+    if (! inputSilent)
+    {
+        idle = false;
+        quietSamples = 0;
+    }
+    else if (idle)
+    {
+        skipSilentBlock(channels, numChannels, numSamples);
+        return;
+    }
+
+    measuringTail = inputSilent;
+    tailPeak = 0.0f;
+
+    // Callers may send more samples than prepared for, so work in chunks the scratch buffers can
+    // hold. Chunks also end on the lines of the parameter grid, which is where parameters are
+    // taken and structure changes happen, whatever the call boundaries.
+    const int maxChunk = path.dryBuffer.getNumSamples();
+
+    for (int start = 0; start < numSamples;)
+    {
+        if (gridPosition == 0)
+        {
+            gridParameters = nextGridParameters(true);
+
+            if (gridParameters.oversampling != oversamplingMode)
+                setOversamplingMode(gridParameters.oversampling);
+
+            setRampTargets(gridParameters);
+        }
+
+        const int chunk = std::min({ maxChunk, parameterGrid - gridPosition, numSamples - start });
+        processChunk(channels, start, chunk, gridParameters);
+        start += chunk;
+
+        if ((gridPosition += chunk) < parameterGrid)
+            continue;
+
+        gridPosition = 0;
+
+        // The wet signal has faded out for a program change; the new structure starts from clear state
+        if (switchFadeSamples > 0 && (switchFadeSamples -= parameterGrid) <= 0)
+        {
+            switchFadeSamples = 0;
+            resetFilters();
+        }
+    }
+
+    if (inputSilent)
+    {
+        quietSamples = tailPeak <= silenceThreshold ? quietSamples + numSamples : 0;
+
+        if (quietSamples >= path.oversampler.getLatencySamples() + roundToInt(quietSecondsBeforeSleep * currentSampleRate))
+            sleep();
+    }
+}
+
+template <typename SampleType>
+bool Effect::isInputSilent(const SampleType* const* channels, int numChannels, int numSamples) const noexcept
+{
+    const auto threshold = static_cast<SampleType>(silenceThreshold);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        for (int sample = 0; sample < numSamples; ++sample)
+            if (std::abs(channels[channel][sample]) > threshold)
+                return false;
+
+    return true;
+}
+
+void Effect::sleep() noexcept
+{
+    // The next call with input starts from clean state, on a fresh grid
+    idle = true;
+    gridPosition = 0;
+    floatPath.reset();
+    doublePath.reset();
+}
+
+template <typename SampleType>
+void Effect::skipSilentBlock(SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    for (int channel = 0; channel < numChannels; ++channel)
+        std::fill(channels[channel], channels[channel] + numSamples, SampleType(0));
+
+    // Keep the LFO and ramps moving, so waking up sounds as if processing never stopped.
+    // Nothing is audible, so a program change applies at once.
+    const auto params = nextGridParameters(false);
+
+    // The state is clear while sleeping, and stays clear: no dry crossfade to finish on waking
+    if (params.oversampling != oversamplingMode)
+    {
+        setOversamplingMode(params.oversampling);
+        floatPath.reset();
+        doublePath.reset();
+    }
+
+    lfo.advance(params.rate / currentSampleRate, numSamples);
+
+    std::array<int, LFOBank::numLFOs> waveforms {};
+    std::array<double, LFOBank::numLFOs> increments {};
+    getLFOBankSettings(params, waveforms.data(), increments.data());
+    lfoBank.advance(increments.data(), numSamples);
+
+    setRampTargets(params);
+
+    for (auto& smoother : smoothers)
+        smoother.skip(numSamples);
+
+    frequencySmoother.skip(numSamples);
+    structureFade.skip(numSamples);
+    skippedBlocks.store(skippedBlocks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+Effect::Parameters Effect::nextGridParameters(bool fadeStructureChanges) noexcept
+{
+    if (parameterSource != nullptr)
+        parameterSource->updateParameters(*this);
+
+    // Switching engines mid-signal would click, so an engine change on its own fades like a program
+    const bool engineChanged = nextParameters.filterEngine != lastParameters.filterEngine;
+
+    if (programChanged || engineChanged)
+    {
+        programChanged = false;
+
+        const auto& running = switchFadeSamples > 0 ? heldParameters : lastParameters;
+        bool structureChanged = nextParameters.waveform != running.waveform || nextParameters.tempoSync != running.tempoSync
+                             || nextParameters.filterType != running.filterType
+                             || nextParameters.oversampling != running.oversampling
+                             || nextParameters.filterEngine != running.filterEngine
+                             || nextParameters.modulationWaveforms != running.modulationWaveforms;
+
+        for (size_t i = 0; i < nextParameters.routes.size(); ++i)
+            structureChanged = structureChanged || nextParameters.routes[i].source != running.routes[i].source
+                                                || nextParameters.routes[i].target != running.routes[i].target
+                                                || nextParameters.routes[i].depth != running.routes[i].depth;
+
+        if (fadeStructureChanges && structureChanged)
+        {
+            heldParameters = running;
+            switchFadeSamples = roundToInt(rampLengthSeconds * currentSampleRate);
+        }
+    }
+
+    lastParameters = nextParameters;
+
+    if (! fadeStructureChanges)
+        switchFadeSamples = 0;
+
+    auto params = lastParameters;
+
+    if (switchFadeSamples > 0)
+    {
+        params.waveform = heldParameters.waveform;
+        params.tempoSync = heldParameters.tempoSync;
+        params.filterType = heldParameters.filterType;
+        params.oversampling = heldParameters.oversampling;
+        params.filterEngine = heldParameters.filterEngine;
+        params.modulationWaveforms = heldParameters.modulationWaveforms;
+        params.routes = heldParameters.routes;
+    }
+
+    params.rate = getEffectiveRate(params.rate, params.tempoSync);
+    return params;
+}
+
+void Effect::setRampTargets(const Parameters& params) noexcept
+{
+    smoothers[depthRamp].setTargetValue(params.depth);
+    smoothers[resonanceRamp].setTargetValue(params.resonance);
+    smoothers[mixRamp].setTargetValue(params.mix);
+    smoothers[stereoWidthRamp].setTargetValue(params.stereoWidth);
+    smoothers[feedbackRamp].setTargetValue(params.feedback);
+    frequencySmoother.setTargetValue(params.frequency);
+    structureFade.setTargetValue(switchFadeSamples > 0 ? 0.0f : 1.0f);
+}
+
+void Effect::getLFOBankSettings(const Parameters& params, int* waveforms, double* increments) const noexcept
+{
+    // Lane 0 is the main LFO, in step with lfo
+    waveforms[0] = static_cast<int>(params.waveform);
+    increments[0] = params.rate / currentSampleRate;
+
+    for (size_t i = 0; i < static_cast<size_t>(numModulationLFOs); ++i)
+    {
+        waveforms[i + 1] = static_cast<int>(params.modulationWaveforms[i]);
+        increments[i + 1] = params.modulationRates[i] / currentSampleRate;
+    }
+}
+
+void Effect::applyModulationMatrix(const Parameters& params, int numSamples, int firstPoint, int interval, int numPoints,
+                                   float* mixValues, float* feedbackValues) noexcept
+{
+    using Matrix = ModulationMatrix;
+
+    std::array<int, LFOBank::numLFOs> waveforms {};
+    std::array<double, LFOBank::numLFOs> increments {};
+    getLFOBankSettings(params, waveforms.data(), increments.data());
+
+    for (int i = 0; i < numRoutes; ++i)
+    {
+        const auto& route = params.routes[static_cast<size_t>(i)];
+        modulationMatrix.setRoute(i, route.source, route.target, route.depth);
+    }
+
+    // With nothing routed the bank only keeps time
+    if (! modulationMatrix.isActive())
+    {
+        lfoBank.advance(increments.data(), numSamples);
+        modulationMatrix.process(lfoBank, 0);
+        return;
+    }
+
+    lfoBank.render(waveforms.data(), increments.data(), numSamples, firstPoint, interval);
+    modulationMatrix.process(lfoBank, numPoints);
+
+    // Full depth moves cutoff and resonance by octaves and the others across their whole range.
+    // Stereo width acts through the LFO phase offset, which falls by half of any rise in width.
+    if (modulationMatrix.isTargeted(Matrix::cutoff))
+        ModulationMapper::scaleByOctaves(pointFrequencies.data(), modulationMatrix.getOffsets(Matrix::cutoff),
+                                         ModulationMapper::octavesAtFullDepth, ModulationMapper::minCutoff,
+                                         ModulationMapper::maxCutoff, numPoints);
+
+    if (modulationMatrix.isTargeted(Matrix::resonance))
+        ModulationMapper::scaleByOctaves(pointResonances.data(), modulationMatrix.getOffsets(Matrix::resonance),
+                                         resonanceOctavesAtFullDepth, 0.1f, 10.0f, numPoints);
+
+    if (modulationMatrix.isTargeted(Matrix::stereoWidth))
+        modulationMatrix.applyToPoints(Matrix::stereoWidth, lfoPhaseOffsets.data(), numPoints, -1.0f, -0.5f, 0.5f);
+
+    if (modulationMatrix.isTargeted(Matrix::mix))
+        modulationMatrix.applyToRamp(Matrix::mix, mixValues, numSamples, firstPoint, interval, 1.0f, 0.0f, 1.0f);
+
+    if (modulationMatrix.isTargeted(Matrix::feedback))
+        modulationMatrix.applyToRamp(Matrix::feedback, feedbackValues, numSamples, firstPoint, interval, 0.95f, 0.0f, 0.95f);
+}
+
+template <typename SampleType>
+void Effect::processChunk(SampleType* const* channels, int startSample, int numSamples, const Parameters& params) noexcept
+{
+    auto& path = getSignalPath<SampleType>();
+    const int totalNumChannels = std::min(numPreparedChannels, path.dryBuffer.getNumChannels());
+
+    // A feedback ramp that stays at zero makes the recursion a no-op, so the chunk skips it
+    const auto& feedbackSmoother = smoothers[feedbackRamp];
+    bool feedbackActive = feedbackSmoother.isSmoothing() || feedbackSmoother.getCurrentValue() != 0.0f;
+
+    // Render the parameter ramps once; every stage below reads from them
+    for (int i = 0; i < numLinearRamps; ++i)
+    {
+        auto* ramp = parameterRamps.getChannel(i);
+
+        for (int sample = 0; sample < numSamples; ++sample)
+            ramp[sample] = smoothers[static_cast<size_t>(i)].getNextValue();
+    }
+
+    auto* frequencyValues = parameterRamps.getChannel(frequencyRamp);
+
+    for (int sample = 0; sample < numSamples; ++sample)
+        frequencyValues[sample] = frequencySmoother.getNextValue();
+
+    const auto* depthValues = parameterRamps.getChannel(depthRamp);
+    const auto* resonanceValues = parameterRamps.getChannel(resonanceRamp);
+    auto* mixValues = parameterRamps.getChannel(mixRamp);
+    const auto* stereoWidthValues = parameterRamps.getChannel(stereoWidthRamp);
+    auto* feedbackValues = parameterRamps.getChannel(feedbackRamp);
+
+    const auto& coefficientEngine = coefficientEngines[static_cast<size_t>(oversamplingMode)];
+
+    // The modulation path runs once per sub-block of controlInterval samples
+    const int interval = coefficientEngine.getControlInterval();
+    const float intervalSmoothing = std::pow(0.95f, static_cast<float>(interval));
+
+    // Keep the dry signal for mixing
+    for (int channel = 0; channel < totalNumChannels; ++channel)
+        std::copy(channels[channel] + startSample, channels[channel] + startSample + numSamples,
+                  path.dryBuffer.getChannel(channel));
+
+    delayDrySignal(path, totalNumChannels, numSamples);
+
+    const int numChannels = std::min({ totalNumChannels, path.filterBank.getNumChannels(), lfo.getNumChannels() });
+
+    // The engine coming in starts from clear state, like after an oversampling change
+    const bool useSvf = params.filterEngine == svfEngine;
+
+    if (params.filterEngine != activeFilterEngine)
+    {
+        activeFilterEngine = params.filterEngine;
+
+        if (useSvf)
+            path.svfBank.reset();
+        else
+            path.filterBank.reset();
+    }
+
+    // The filter type picks the banks' kernel for the whole chunk
+    if (useSvf)
+        path.svfBank.setFilterType(params.filterType);
+    else
+        path.filterBank.setFilterType(params.filterType);
+
+    // Render the LFO for every control point in the chunk. The points sit on the first sample of
+    // each sub-block, on a grid that runs on across chunks, and the coefficients ramp across the
+    // sub-block to the design for its point. The samples before the first point finish the
+    // sub-block an earlier chunk started. The width ramp sets the phase offset of the last
+    // channel; the ones in between are spread evenly from the first channel's phase.
+    const int firstPoint = (interval - gridPosition % interval) % interval;
+    const int numPoints = LFOGenerator::countPoints(numSamples, firstPoint, interval);
+
+    for (int point = 0; point < numPoints; ++point)
+    {
+        const int controlIndex = firstPoint + point * interval;
+        lfoPhaseOffsets[static_cast<size_t>(point)] = (1.0f - stereoWidthValues[controlIndex]) * 0.5f;
+        pointDepths[static_cast<size_t>(point)] = depthValues[controlIndex];
+        pointFrequencies[static_cast<size_t>(point)] = frequencyValues[controlIndex];
+        pointResonances[static_cast<size_t>(point)] = resonanceValues[controlIndex];
+    }
+
+    applyModulationMatrix(params, numSamples, firstPoint, interval, numPoints, mixValues, feedbackValues);
+
+    // A structure change fades the wet signal with the routes to the mix already applied
+    if (structureFade.isSmoothing() || structureFade.getCurrentValue() != 1.0f)
+        for (int sample = 0; sample < numSamples; ++sample)
+            mixValues[sample] *= structureFade.getNextValue();
+
+    feedbackActive = feedbackActive || (modulationMatrix.isActive() && modulationMatrix.isTargeted(ModulationMatrix::feedback));
+
+    lfo.render(static_cast<int>(params.waveform), params.rate / currentSampleRate, numSamples, firstPoint, interval,
+               lfoPhaseOffsets.data());
+
+    // Apply LFO to frequency
+    for (int channel = 0; channel < numChannels; ++channel)
+        ModulationMapper::mapToCutoff(lfo.getValues(channel), pointDepths.data(), pointFrequencies.data(),
+                                      pointCutoffs.getChannel(channel), numPoints);
+
+    // With oversampling, the filter runs on factor times as many samples in the oversampler's buffers
+    const int factor = path.oversampler.getFactor();
+    SampleType* const* filterChannels = channels;
+    int filterStart = startSample;
+
+    if (factor > 1)
+    {
+        filterChannels = path.oversampler.processUp(channels, startSample, numSamples);
+        filterStart = 0;
+    }
+
+    // All channels in one pass; within a sub-block the coefficients ramp towards its targets
+    auto runFilters = [&](int start, int length)
+    {
+        if (useSvf)
+            path.svfBank.process(filterChannels, filterStart + start * factor, length * factor);
+        else
+            path.filterBank.process(filterChannels, filterStart + start * factor, length * factor);
+    };
+
+    runFilters(0, std::min(firstPoint, numSamples));
+
+    for (int point = 0; point < numPoints; ++point)
+    {
+        const int start = firstPoint + point * interval;
+        const float resonance = pointResonances[static_cast<size_t>(point)];
+        std::array<float, 2> appliedCutoff {};
+
+        // Channels that land on the same cutoff (all of them, with no phase spread) share one design
+        BiquadCoefficients coefficients {};
+        SvfCoefficients svfCoefficients {};
+        float designedCutoff = -1.0f;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const float modulatedFreq = pointCutoffs.getChannel(channel)[point];
+
+            // Simple one-pole filter for smooth modulation, advanced by a whole sub-block.
+            // The SVF's state doesn't depend on its coefficients, so it follows the LFO directly.
+            float& smoothedFreq = smoothedCutoffs[static_cast<size_t>(channel)];
+            smoothedFreq = useSvf ? modulatedFreq : modulatedFreq + (smoothedFreq - modulatedFreq) * intervalSmoothing;
+
+            if (useSvf)
+            {
+                if (smoothedFreq != designedCutoff)
+                {
+                    svfCoefficients = designSvf(params.filterType, smoothedFreq, resonance, coefficientEngine.getSampleRate());
+                    designedCutoff = smoothedFreq;
+                }
+
+                path.svfBank.setTarget(channel, svfCoefficients);
+            }
+            else
+            {
+                if (smoothedFreq != designedCutoff)
+                {
+                    coefficients = coefficientEngine.design(params.filterType, smoothedFreq, resonance);
+                    designedCutoff = smoothedFreq;
+                }
+
+                path.filterBank.setTarget(channel, coefficients);
+            }
+
+            if (channel == 0)               appliedCutoff[0] = smoothedFreq;
+            if (channel == numChannels - 1) appliedCutoff[1] = smoothedFreq;
+        }
+
+        if (useSvf)
+            path.svfBank.startRamp(interval * factor);
+        else
+            path.filterBank.startRamp(interval * factor);
+
+        // Decimated telemetry for a display; dropped if nobody is reading
+        telemetryCountdown -= interval;
+
+        if (telemetryCountdown <= 0 && numChannels > 0)
+        {
+            telemetryCountdown += telemetryInterval;
+
+            if (telemetry != nullptr)
+            {
+                ModulationFrame frame;
+                frame.lfo = { lfo.getValues(0)[point], lfo.getValues(numChannels - 1)[point] };
+                frame.cutoff = appliedCutoff;
+                telemetry->push(frame);
+            }
+        }
+
+        runFilters(start, std::min(interval, numSamples - start));
+    }
+
+    if (factor > 1)
+        path.oversampler.processDown(channels, startSample, numSamples);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* channelData = channels[channel] + startSample;
+        const auto* dryData = path.dryBuffer.getChannel(channel);
+
+        auto& lastWetSample = path.lastWetSamples[static_cast<size_t>(channel)];
+
+        if (feedbackActive)
+            OutputStage::applyFeedback(channelData, feedbackValues, numSamples, lastWetSample);
+        else
+            lastWetSample = channelData[numSamples - 1];
+
+        if (measuringTail)
+            for (int sample = 0; sample < numSamples; ++sample)
+                tailPeak = std::max(tailPeak, static_cast<float>(std::abs(channelData[sample])));
+
+        OutputStage::mixDryWet(channelData, dryData, mixValues, numSamples);
+    }
+}
+
+} // namespace flarksiesis
@@ -0,0 +1,298 @@
+#pragma once
+
+#include "BiquadBank.h"
+#include "ChannelBuffer.h"
+#include "CoefficientEngine.h"
+#include "LFOBank.h"
+#include "LFOGenerator.h"
+#include "ModulationMatrix.h"
+#include "Oversampler.h"
+#include "Smoother.h"
+#include "SpscQueue.h"
+#include "SvfBank.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace flarksiesis
+{
+
+// LFO waveforms, in the order of the "waveform" choices; the values match LFOGenerator::Waveform
+enum class LFOWaveform
+{
+    Sine = 0,
+    Triangle,
+    Square,
+    Saw,
+    Random
+};
+
+// Filter engines: the delta-operator biquads, or the zero-delay-feedback state-variable filter,
+// which takes audio-rate cutoff changes without the one-pole smoothing
+enum FilterEngine { biquadEngine = 0, svfEngine };
+
+//==============================================================================
+/**
+    The whole effect, free of JUCE: the LFOs and modulation matrix, the filter
+    engines, oversampling, feedback and the dry/wet mix, run on plain channel
+    pointers with every parameter in one plain struct. The plugin is an adapter
+    around it, and anything else (a render engine, the command line tools) can
+    run it without an AudioProcessor, a parameter tree or a message thread.
+
+    Constructing one allocates nothing. prepare() allocates everything for the
+    sample rate, channel count and sample type; process() then never allocates,
+    locks or blocks, and leaves the audio alone until prepare() has been called
+    for the sample type it is given.
+
+    Parameters are taken every parameterReadInterval samples, from the ones
+    last passed to setParameters(), and the filter coefficients are updated
+    every control interval. Both grids run on from prepare() across calls, so
+    the output doesn't depend on how the caller splits the stream into blocks.
+    The continuous parameters ramp over 20 ms. changeProgram() is for a whole
+    new set at once: if it changes the structure (filter type or engine,
+    waveforms, oversampling, tempo sync, routes) the wet signal fades out
+    under the old structure and back in under the new one. A change of filter
+    engine is faded the same way whichever call it comes from. A ParameterSource
+    is called on every line of the parameter grid, for callers whose
+    parameters live elsewhere and may move during a long block.
+
+    Once the input is silent and the tail has decayed, calls are passed
+    through as silence without running the DSP, until input returns.
+*/
+class Effect
+{
+public:
+    static constexpr int maxChannels = 64; // Third-order ambisonics is 16
+    static constexpr int numModulationLFOs = LFOBank::numLFOs - 1;
+    static constexpr int numRoutes = ModulationMatrix::numRoutes;
+
+    // LFO 1 is the main LFO and LFOs 2 to 4 run free; a route sends one of them to a continuous
+    // parameter (ModulationMatrix::Target) with its own depth
+    struct ModulationRoute
+    {
+        int source = 0; // LFO 1 to 4
+        int target = 0; // ModulationMatrix::Target
+        float depth = 0.0f;
+    };
+
+    // Every parameter, in the units and ranges the plugin shows them in
+    struct Parameters
+    {
+        float rate = 2.0f;      // Hz, or a note division under tempo sync
+        float depth = 0.5f;
+        LFOWaveform waveform = LFOWaveform::Sine;
+        bool tempoSync = false;
+        float frequency = 1000.0f; // Hz
+        float resonance = 0.707f;
+        int filterType = 0;     // FilterCoefficients.h
+        float mix = 0.5f;
+        float stereoWidth = 1.0f;
+        float feedback = 0.0f;
+        int oversampling = 0;   // Index into Off, 2x, 4x
+        int filterEngine = biquadEngine;
+
+        std::array<float, numModulationLFOs> modulationRates { 0.5f, 0.13f, 3.0f };
+        std::array<LFOWaveform, numModulationLFOs> modulationWaveforms { LFOWaveform::Sine, LFOWaveform::Triangle,
+                                                                         LFOWaveform::Random };
+        std::array<ModulationRoute, numRoutes> routes {};
+    };
+
+    //==============================================================================
+    /** Allocates for up to maxFramesPerCall frames per chunk (longer calls are split) in the given
+        sample type, and starts the ramps at the parameters last set.
+    */
+    void prepare(double sampleRate, int numChannels, int maxFramesPerCall, bool doublePrecision = false);
+    void release();
+
+    /** Processes numFrames frames in place. numChannels must be the count given to prepare(). */
+    void process(float* const* channels, int numChannels, int numFrames) noexcept;
+    void process(double* const* channels, int numChannels, int numFrames) noexcept;
+
+    //==============================================================================
+    /** Applied from the next parameter grid line on; the continuous parameters ramp to their new values,
+        and a new filter engine fades in as for a program change. */
+    void setParameters(const Parameters& newParameters) noexcept;
+
+    /** Like setParameters(), for a new program or state: changes to the structure are faded. */
+    void changeProgram(const Parameters& newParameters) noexcept;
+
+    const Parameters& getParameters() const noexcept { return nextParameters; }
+
+    /** The host tempo for tempo-synced rates; 0 when unknown, which leaves the rate in Hz. */
+    void setTempo(double beatsPerMinute) noexcept { tempo = beatsPerMinute; }
+
+    /** Called by process() on every line of the parameter grid, and for every skipped call. */
+    struct ParameterSource
+    {
+        virtual ~ParameterSource() = default;
+        virtual void updateParameters(Effect& effect) noexcept = 0;
+    };
+
+    void setParameterSource(ParameterSource* source) noexcept { parameterSource = source; }
+
+    /** Samples between filter coefficient updates; applied at the next prepare(). */
+    void setControlInterval(int samples) noexcept { controlInterval = samples; }
+    int getControlInterval() const noexcept { return coefficientEngines[0].getControlInterval(); }
+
+    //==============================================================================
+    /** The delay of the wet and dry signal, which follows the oversampling mode; safe from any thread. */
+    int getLatencySamples() const noexcept { return latency.load(std::memory_order_relaxed); }
+
+    /** How long the output takes to decay below -100 dBFS after the input stops, with these parameters. */
+    double getTailLengthSeconds(const Parameters& parameters) const noexcept;
+
+    /** Calls passed through as silence, without running the DSP, since prepare(); safe from any thread. */
+    std::uint64_t getNumSkippedBlocks() const noexcept { return skippedBlocks.load(std::memory_order_relaxed); }
+
+    // The modulation applied, for display; about telemetryRateHz frames per second
+    struct ModulationFrame
+    {
+        std::array<float, 2> lfo {};    // First and last channel
+        std::array<float, 2> cutoff {}; // Smoothed cutoff in Hz, as handed to the filter
+    };
+    using ModulationTelemetry = SpscQueue<ModulationFrame, 1024>;
+    static constexpr double telemetryRateHz = 120.0;
+
+    /** process() pushes frames into this queue while it is set; frames it can't take are dropped. */
+    void setTelemetry(ModulationTelemetry* queue) noexcept { telemetry = queue; }
+
+    // Parameters are taken again every parameterReadInterval samples, so automation that moves
+    // during a long block isn't held for all of it
+    static constexpr int parameterReadInterval = 128;
+
+private:
+    //==============================================================================
+    // Per-sample ramps for the continuous parameters, one row each in parameterRamps.
+    // The cutoff ramps in the log domain, so a sweep moves evenly through the octaves.
+    enum RampIndex { depthRamp = 0, resonanceRamp, mixRamp, stereoWidthRamp, feedbackRamp, numLinearRamps,
+                     frequencyRamp = numLinearRamps, numRamps };
+    std::array<Smoother<linearSmoothing>, numLinearRamps> smoothers;
+    Smoother<multiplicativeSmoothing> frequencySmoother;
+    ChannelBuffer<float> parameterRamps;
+
+    // Gain on the mix ramp, after the modulation matrix: it falls to 0 while a structure change
+    // fades out and rises back to 1 once the new structure runs, whatever routes act on the mix
+    Smoother<linearSmoothing> structureFade;
+    static constexpr double rampLengthSeconds = 0.02;
+
+    // The parameter grid is a multiple of the control interval, and both start at prepare(); a
+    // chunk never crosses a line of the parameter grid. Sleeping restarts them.
+    int parameterGrid = parameterReadInterval;
+    int gridPosition = 0;       // Samples since the last line of the parameter grid
+    Parameters gridParameters;  // Taken on that line
+
+    // Everything that carries audio, once per sample type; the control path (LFOs, ramps,
+    // coefficient designs) is float for both. prepare() allocates the path for the
+    // precision asked for and frees the other.
+    template <typename SampleType>
+    struct SignalPath
+    {
+        ChannelBuffer<SampleType> dryBuffer; // Its length is the largest chunk processed at once
+
+        // Filter state (all channels, interleaved for SIMD). One of the two engines runs, per
+        // Parameters::filterEngine; the other keeps its state cleared.
+        BiquadBank<SampleType> filterBank;
+        SvfBank<SampleType> svfBank;
+
+        // Oversampling around the filter stage; the dry path is delayed to match. The delay line
+        // holds the longest latency, so a change of factor crossfades the dry signal from the
+        // old delay to the new one instead of restarting it from silence.
+        Oversampler<SampleType> oversampler;
+        ChannelBuffer<SampleType> dryDelay;
+        int dryDelayPosition = 0;
+        int dryCrossfadeLength = 1;
+        int dryCrossfadeRemaining = 0;
+        int dryCrossfadeFromDelay = 0;
+
+        AlignedVector<SampleType> lastWetSamples; // Per channel, for the feedback recursion
+
+        void prepare(int numChannels, int samplesPerBlock, int crossfadeSamples);
+        void release();
+        void reset() noexcept; // Filters, oversampler and dry delay
+        void resetFilters() noexcept;
+        void setOversamplingFactor(int factor) noexcept; // Keeps the dry delay, crossfading it
+    };
+    template <typename SampleType> SignalPath<SampleType>& getSignalPath() noexcept;
+
+    double currentSampleRate = 44100.0;
+    int numPreparedChannels = 0;
+
+    SignalPath<float> floatPath;
+    SignalPath<double> doublePath;
+
+    // LFO state: rendered for the whole chunk, one value per control point and channel
+    LFOGenerator lfo;
+    AlignedVector<float> lfoPhaseOffsets;  // Stereo offset per control point, from the width ramp
+    AlignedVector<float> pointDepths;      // Depth ramp sampled at the control points
+    AlignedVector<float> pointFrequencies; // Cutoff ramp sampled at the control points
+    ChannelBuffer<float> pointCutoffs;     // Modulated cutoff per channel and control point
+    AlignedVector<float> pointResonances;  // Resonance ramp sampled at the control points
+
+    // Modulation matrix, evaluated at the same control points
+    LFOBank lfoBank;
+    ModulationMatrix modulationMatrix;
+    static constexpr float resonanceOctavesAtFullDepth = 2.0f;
+    AlignedVector<float> smoothedCutoffs;  // One-pole cutoff smoother state per channel
+
+    int activeFilterEngine = biquadEngine;
+
+    // One engine per oversampling mode (Off, 2x, 4x), each designing for its own rate
+    static constexpr int numOversamplingModes = 3;
+    std::array<CoefficientEngine, numOversamplingModes> coefficientEngines;
+    int controlInterval = CoefficientEngine::defaultControlInterval;
+
+    int oversamplingMode = 0;
+
+    // The parameters set for the next grid line, those taken on the last one, and the program change
+    // being faded: when a new program changes the structure, the wet signal fades out under
+    // the old structure, the filter state is cleared, and it fades back in under the new one
+    Parameters nextParameters;
+    Parameters lastParameters;
+    Parameters heldParameters;
+    bool programChanged = false;
+    int switchFadeSamples = 0;
+    double tempo = 0.0;
+    ParameterSource* parameterSource = nullptr;
+
+    ModulationTelemetry* telemetry = nullptr;
+    int telemetryInterval = 400;  // Samples between frames
+    int telemetryCountdown = 0;
+
+    // Sleeping on silence: once the input is silent and the wet signal has stayed under
+    // silenceThreshold for the latency plus quietSecondsBeforeSleep, the DSP state is cleared
+    // and calls are skipped until one with input arrives, which is processed in full
+    static constexpr float silenceThreshold = 1.0e-5f; // -100 dBFS
+    static constexpr double quietSecondsBeforeSleep = 0.01;
+    bool idle = false;
+    bool measuringTail = false;  // Set for silent input; processChunk then fills tailPeak
+    float tailPeak = 0.0f;
+    int quietSamples = 0;
+
+    // Read by other threads, so on a cache line of their own (which also aligns the whole effect)
+    alignas(cacheLineSize) std::atomic<int> latency {0};
+    std::atomic<std::uint64_t> skippedBlocks {0};
+
+    //==============================================================================
+    template <typename SampleType>
+    void processSamples(SampleType* const* channels, int numChannels, int numSamples) noexcept;
+    template <typename SampleType>
+    void processChunk(SampleType* const* channels, int startSample, int numSamples, const Parameters& params) noexcept;
+    void setRampTargets(const Parameters& params) noexcept;
+    void getLFOBankSettings(const Parameters& params, int* waveforms, double* increments) const noexcept;
+    void applyModulationMatrix(const Parameters& params, int numSamples, int firstPoint, int interval, int numPoints,
+                               float* mixValues, float* feedbackValues) noexcept;
+    template <typename SampleType>
+    bool isInputSilent(const SampleType* const* channels, int numChannels, int numSamples) const noexcept;
+    template <typename SampleType>
+    void skipSilentBlock(SampleType* const* channels, int numChannels, int numSamples) noexcept;
+    void sleep() noexcept;
+    Parameters nextGridParameters(bool fadeStructureChanges) noexcept;
+    float getEffectiveRate(float rateParam, bool tempoSync) const noexcept;
+    void setOversamplingMode(int mode) noexcept;
+    void resetFilters() noexcept;
+    template <typename SampleType>
+    void delayDrySignal(SignalPath<SampleType>& path, int numChannels, int numSamples) noexcept;
+};
+
+} // namespace flarksiesis
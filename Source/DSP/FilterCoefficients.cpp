@@ -0,0 +1,113 @@
+#include "FilterCoefficients.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace flarksiesis
+{
+
+BiquadCoefficients designBiquad(int filterType, float frequency, float resonance, double sampleRate)
+{
+    constexpr double twoPi = 6.283185307179586;
+
+    const double omega = twoPi * frequency / sampleRate;
+    const double q = resonance;
+
+    // The RBJ cookbook designs (0-4) share their poles. 1 - cos w is written as 2 sin^2 (w / 2),
+    // which keeps its precision where cos w rounds to 1.
+    const double sinHalfOmega = std::sin(omega / 2.0);
+    const double oneMinusCos = 2.0 * sinHalfOmega * sinHalfOmega;
+    const double alpha = std::sin(omega) / (2.0 * q);
+    const double norm = 1.0 / (1.0 + alpha);
+
+    // The bilinear designs (5-7) with prewarping: tan (w / 2)
+    const double k = std::tan(omega / 2.0);
+    const double bilinearNorm = 1.0 / (1.0 + k / q + k * k);
+
+    BiquadCoefficients c;
+
+    if (filterType >= 0 && filterType <= 4)
+    {
+        c.a1 = 2.0 * (oneMinusCos + alpha) * norm;
+        c.a2 = 2.0 * oneMinusCos * norm;
+    }
+    else if (filterType >= 5 && filterType <= 7)
+    {
+        c.a1 = (2.0 * k / q + 4.0 * k * k) * bilinearNorm;
+        c.a2 = 4.0 * k * k * bilinearNorm;
+    }
+
+    // The relations FilterResponse names are set exactly, not left to rounding
+    switch (filterType)
+    {
+        case 0: // Lowpass 24dB
+        case 5: // Lowpass 12dB
+            c.b0 = 0.25 * c.a2;
+            c.b1 = c.b2 = c.a2;
+            break;
+
+        case 1: // Highpass 24dB: (1 + cos w) / 2
+            c.b0 = (1.0 - 0.5 * oneMinusCos) * norm;
+            c.b1 = c.b2 = 0.0;
+            break;
+
+        case 6: // Highpass 12dB
+            c.b0 = bilinearNorm;
+            c.b1 = c.b2 = 0.0;
+            break;
+
+        case 2: // Bandpass
+            c.b0 = alpha * norm;
+            c.b1 = 2.0 * c.b0;
+            c.b2 = 0.0;
+            break;
+
+        case 7: // Bandpass 12dB
+            c.b0 = k / q * bilinearNorm;
+            c.b1 = 2.0 * c.b0;
+            c.b2 = 0.0;
+            break;
+
+        case 3: // Notch
+            c.b0 = norm;
+            c.b1 = c.b2 = c.a2;
+            break;
+
+        case 4: // Allpass
+            c.b0 = (1.0 - alpha) * norm;
+            c.b1 = 2.0 * (oneMinusCos - alpha) * norm;
+            c.b2 = c.a2;
+            break;
+
+        default: // Passes the input through
+            c = {};
+    }
+
+    return c;
+}
+
+SvfCoefficients designSvf(int filterType, float frequency, float resonance, double sampleRate) noexcept
+{
+    constexpr double pi = 3.141592653589793;
+
+    // Just below Nyquist, where tan() heads for infinity
+    const double nyquistFraction = std::min(0.49, std::max(0.0, static_cast<double>(frequency) / sampleRate));
+
+    SvfCoefficients c;
+    c.g = static_cast<float>(std::tan(pi * nyquistFraction));
+    c.k = 1.0f / std::max(0.01f, resonance);
+
+    switch (getFilterResponse(filterType))
+    {
+        case lowpassResponse:  c.m0 = 0.0f; c.m1 = 0.0f;        c.m2 = 1.0f;  break;
+        case highpassResponse: c.m0 = 1.0f; c.m1 = -c.k;        c.m2 = -1.0f; break;
+        case bandpassResponse: c.m0 = 0.0f; c.m1 = c.k;         c.m2 = 0.0f;  break; // 0 dB peak
+        case notchResponse:    c.m0 = 1.0f; c.m1 = -c.k;        c.m2 = 0.0f;  break;
+        case allpassResponse:  c.m0 = 1.0f; c.m1 = -2.0f * c.k; c.m2 = 0.0f;  break;
+        default:               c.m0 = 1.0f; c.m1 = 0.0f;        c.m2 = 0.0f;  break;
+    }
+
+    return c;
+}
+
+} // namespace flarksiesis
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+
+namespace flarksiesis
+{
+
+//==============================================================================
+// Normalised biquad coefficients in delta-operator form, designed in double:
+//
+//     H = (b0 q^2 + b1 q + b2) / (q^2 + a1 q + a2),   q = z - 1
+//
+// In terms of the direct form's coefficients that is b0, 2 b0 + b1, b0 + b1 + b2, 2 + a1 and
+// 1 + a1 + a2. For a cutoff far below the sample rate the direct form's a1 and a2 head for -2
+// and 1 and the response hangs on the last bits of their sum; here those small differences are
+// the coefficients themselves, so they keep their full relative precision at any rate.
+struct BiquadCoefficients
+{
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0;
+    double a1 = 0.0, a2 = 0.0;
+};
+
+// Filter memory for one channel: the two integrators of the delta-operator
+// transposed direct form II (see CoefficientEngine::processRamped())
+template <typename SampleType>
+struct BiquadState
+{
+    std::array<SampleType, 2> z = {};
+};
+
+// The responses the eight "filtertype" choices come in. Every design of one response keeps
+// fixed relations between its coefficients (b1 == b2 == a2 == 4 b0 for the lowpasses, b1 == b2
+// == 0 for the highpasses, an SVF mix that only follows k, ...), which the filter banks'
+// specialised kernels build in.
+enum FilterResponse
+{
+    lowpassResponse = 0,
+    highpassResponse,
+    bandpassResponse,
+    notchResponse,
+    allpassResponse,
+    genericResponse,
+    numFilterResponses
+};
+
+// 24 dB and 12 dB variants share a response; anything out of range is generic
+inline FilterResponse getFilterResponse(int filterType) noexcept
+{
+    switch (filterType)
+    {
+        case 0: case 5: return lowpassResponse;
+        case 1: case 6: return highpassResponse;
+        case 2: case 7: return bandpassResponse;
+        case 3:         return notchResponse;
+        case 4:         return allpassResponse;
+        default:        return genericResponse;
+    }
+}
+
+// Designs the coefficients for one of the eight "filtertype" choices, in double.
+// This is the reference design: it calls the trig functions directly.
+BiquadCoefficients designBiquad(int filterType, float frequency, float resonance, double sampleRate);
+
+// Topology-preserving-transform state-variable filter: g = tan (pi fc / fs) and k = 1 / Q set
+// the shared state, and every response is a mix of it, m0 * input + m1 * band + m2 * low
+struct SvfCoefficients
+{
+    float g = 0.0f, k = 2.0f;
+    float m0 = 1.0f, m1 = 0.0f, m2 = 0.0f;
+};
+
+// The same eight "filtertype" responses as designBiquad() (the bilinear transform with
+// prewarping gives identical transfer functions), for one tan call
+SvfCoefficients designSvf(int filterType, float frequency, float resonance, double sampleRate) noexcept;
+
+} // namespace flarksiesis
@@ -0,0 +1,104 @@
+#include "KernelsImpl.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if FLARKSIESIS_DISPATCH_AVX2
+ #if defined(_MSC_VER)
+  #include <intrin.h>
+ #else
+  #include <cpuid.h>
+ #endif
+#endif
+
+namespace flarksiesis
+{
+
+#if FLARKSIESIS_DISPATCH_AVX2
+extern const KernelSet avx2Kernels; // KernelsAvx2.cpp
+#endif
+
+namespace
+{
+
+#if FLARKSIESIS_SIMD_SSE2
+constexpr KernelSet baselineKernels = makeKernelSet("sse2");
+#elif FLARKSIESIS_SIMD_NEON
+constexpr KernelSet baselineKernels = makeKernelSet("neon");
+#else
+constexpr KernelSet baselineKernels = makeKernelSet("scalar");
+#endif
+
+#if FLARKSIESIS_DISPATCH_AVX2
+// AVX2 in the CPU, and an OS that saves the YMM registers across context switches
+bool cpuSupportsAvx2() noexcept
+{
+    constexpr unsigned int osxsaveBit = 1u << 27, avxBit = 1u << 28; // CPUID 1, ECX
+    constexpr unsigned int avx2Bit = 1u << 5;                        // CPUID 7, EBX
+    constexpr unsigned int xmmAndYmmState = 6u;                      // XCR0
+
+ #if defined(_MSC_VER)
+    int info[4] = {};
+    __cpuid(info, 0);
+
+    if (info[0] < 7)
+        return false;
+
+    __cpuid(info, 1);
+    const auto features = static_cast<unsigned int>(info[2]);
+
+    if ((features & (osxsaveBit | avxBit)) != (osxsaveBit | avxBit))
+        return false;
+
+    if ((_xgetbv(0) & xmmAndYmmState) != xmmAndYmmState)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (static_cast<unsigned int>(info[1]) & avx2Bit) != 0;
+ #else
+    if (__get_cpuid_max(0, nullptr) < 7)
+        return false;
+
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    __cpuid(1, eax, ebx, ecx, edx);
+
+    if ((ecx & (osxsaveBit | avxBit)) != (osxsaveBit | avxBit))
+        return false;
+
+    // xgetbv by hand: the intrinsic needs -mxsave, which this file isn't built with
+    unsigned int xcr0 = 0, xcr0High = 0;
+    __asm__ ("xgetbv" : "=a" (xcr0), "=d" (xcr0High) : "c" (0));
+
+    if ((xcr0 & xmmAndYmmState) != xmmAndYmmState)
+        return false;
+
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & avx2Bit) != 0;
+ #endif
+}
+#endif
+
+const KernelSet& chooseKernels() noexcept
+{
+    const char* forced = std::getenv("FLARKSIESIS_KERNELS");
+
+    if (forced != nullptr && std::strcmp(forced, "baseline") == 0)
+        return baselineKernels;
+
+#if FLARKSIESIS_DISPATCH_AVX2
+    if (cpuSupportsAvx2())
+        return avx2Kernels;
+#endif
+
+    return baselineKernels;
+}
+
+} // namespace
+
+const KernelSet& getKernels() noexcept
+{
+    static const KernelSet& kernels = chooseKernels();
+    return kernels;
+}
+
+} // namespace flarksiesis
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "FilterCoefficients.h"
+
+// CMake defines FLARKSIESIS_AVX2_KERNELS when building for x86. A universal macOS build
+// compiles the same sources for arm64 as well, which has nothing to choose between.
+#if FLARKSIESIS_AVX2_KERNELS && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86))
+ #define FLARKSIESIS_DISPATCH_AVX2 1
+#endif
+
+namespace flarksiesis
+{
+
+//==============================================================================
+// Filter state for four channels, one SIMD lane each, as BiquadBank and SvfBank keep it
+template <typename SampleType>
+struct alignas(32) BiquadLanes
+{
+    static constexpr int lanes = 4;
+
+    SampleType s1[lanes], s2[lanes]; // Integrator states (see BiquadState)
+    SampleType b0[lanes], b1[lanes], b2[lanes], a1[lanes], a2[lanes];
+    SampleType tb0[lanes], tb1[lanes], tb2[lanes], ta1[lanes], ta2[lanes];
+    SampleType db0[lanes], db1[lanes], db2[lanes], da1[lanes], da2[lanes]; // Per-sample steps of the ramp
+    bool hasCoefficients[lanes];
+};
+
+template <typename SampleType>
+struct alignas(32) SvfLanes
+{
+    static constexpr int lanes = 4;
+
+    SampleType ic1[lanes], ic2[lanes];
+    SampleType g[lanes], k[lanes], m0[lanes], m1[lanes], m2[lanes];
+    SampleType tg[lanes], tk[lanes], tm0[lanes], tm1[lanes], tm2[lanes];
+    SampleType dg[lanes], dk[lanes], dm0[lanes], dm1[lanes], dm2[lanes];
+    bool hasCoefficients[lanes];
+};
+
+//==============================================================================
+// The kernels of one sample type. A filter kernel runs numSamples of the four lanes in
+// place, moving the coefficients by the steps the bank set when the ramp started, and
+// stores the coefficients it reached. The bank lands them on the targets when the ramp
+// ends, so the rounding of the steps never accumulates.
+template <typename SampleType>
+struct SampleKernels
+{
+    using BiquadKernel = void (*)(BiquadLanes<SampleType>&, SampleType* const* lanePointers, int numSamples) noexcept;
+    using SvfKernel = void (*)(SvfLanes<SampleType>&, SampleType* const* lanePointers, int numSamples) noexcept;
+
+    BiquadKernel biquad[numFilterResponses];
+    SvfKernel svf[numFilterResponses];
+
+    // OutputStage::mixDryWet()
+    void (*mixDryWet)(SampleType* wet, const SampleType* dry, const float* mix, int numSamples) noexcept;
+};
+
+//==============================================================================
+/**
+    The hot loops, built once per instruction set: the filter banks, the LFO
+    shapes, the exp2 cutoff mapping and the dry/wet mix.
+
+    KernelsImpl.h holds them, and each source that includes it compiles them
+    with its own flags: Kernels.cpp for the target's baseline (SSE2 on x86-64,
+    NEON on AArch64), and on x86 KernelsAvx2.cpp for AVX2 as well. The
+    baseline build never runs instructions the CPU might lack; getKernels()
+    checks with CPUID once and hands out the best set the CPU and OS support.
+
+    FLARKSIESIS_KERNELS=baseline in the environment forces the baseline set,
+    to compare the two on one machine.
+*/
+struct KernelSet
+{
+    const char* name; // "sse2", "avx2", "neon" or "scalar"
+
+    SampleKernels<float> floatKernels;
+    SampleKernels<double> doubleKernels;
+
+    // LFOGenerator::evaluateBlock()
+    void (*evaluateWaveform)(int waveform, const float* phases, float* out, int numValues) noexcept;
+
+    // ModulationMapper::mapToCutoff() and scaleByOctaves()
+    void (*mapToCutoff)(const float* lfoValues, const float* depthValues, const float* baseFrequencies,
+                        float* cutoffs, int numValues) noexcept;
+    void (*scaleByOctaves)(float* values, const float* offsets, float octavesAtFullScale,
+                           float lowest, float highest, int numValues) noexcept;
+
+    template <typename SampleType>
+    const SampleKernels<SampleType>& forSampleType() const noexcept;
+};
+
+template <> inline const SampleKernels<float>& KernelSet::forSampleType<float>() const noexcept   { return floatKernels; }
+template <> inline const SampleKernels<double>& KernelSet::forSampleType<double>() const noexcept { return doubleKernels; }
+
+// Chooses on the first call, which is thread-safe; afterwards it's a plain read
+const KernelSet& getKernels() noexcept;
+
+} // namespace flarksiesis
@@ -0,0 +1,22 @@
+// The kernels once more, for x86 CPUs with AVX2. CMake builds this file alone with AVX2
+// enabled, but not FMA, so the results match the baseline kernels bit for bit; getKernels()
+// only hands these out once CPUID has confirmed the CPU and OS run them.
+#define FLARKSIESIS_ISA avx2
+
+#include "KernelsImpl.h"
+
+#if FLARKSIESIS_DISPATCH_AVX2
+
+ #if ! defined(__AVX2__)
+  #error "KernelsAvx2.cpp has to be compiled with AVX2 enabled"
+ #endif
+
+namespace flarksiesis
+{
+
+extern const KernelSet avx2Kernels;
+const KernelSet avx2Kernels = makeKernelSet("avx2");
+
+} // namespace flarksiesis
+
+#endif
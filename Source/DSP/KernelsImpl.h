@@ -0,0 +1,357 @@
+#pragma once
+
+// The kernels behind KernelSet, included once by each KernelsXxx.cpp (and by Kernels.cpp for
+// the baseline). Everything here is in the FLARKSIESIS_ISA namespace and only calls code that
+// is too, or intrinsics: see SimdFloat4.h for why.
+
+#include "Kernels.h"
+#include "LFOGenerator.h"
+#include "LFOShapes.h"
+#include "ModulationMapper.h"
+#include "SimdDouble4.h"
+
+namespace flarksiesis
+{
+inline namespace FLARKSIESIS_ISA
+{
+
+//==============================================================================
+// Delta-operator biquads, ramped like CoefficientEngine::processRamped(). The shaped kernels
+// ramp only the coefficients their response leaves free (see FilterResponse).
+template <typename SampleType, int Response>
+void biquadKernel(BiquadLanes<SampleType>& group, SampleType* const* lane, int numSamples) noexcept
+{
+    using Vector = typename SimdVector<SampleType>::Type;
+    constexpr int lanes = BiquadLanes<SampleType>::lanes;
+
+    const Vector quarter = Vector::broadcast(SampleType(0.25));
+
+    Vector b0 = Vector::load(group.b0), b1 = Vector::load(group.b1), b2 = Vector::load(group.b2);
+    Vector a1 = Vector::load(group.a1), a2 = Vector::load(group.a2);
+
+    const Vector db0 = Vector::load(group.db0), db1 = Vector::load(group.db1), db2 = Vector::load(group.db2);
+    const Vector da1 = Vector::load(group.da1), da2 = Vector::load(group.da2);
+
+    Vector s1 = Vector::load(group.s1), s2 = Vector::load(group.s2);
+
+    auto tick = [&](Vector input)
+    {
+        // Only what the response leaves free is ramped; the other coefficients are zero, or
+        // equal to or a power-of-two multiple of these, exactly so along a ramp between two
+        // designs of the response
+        if constexpr (Response == genericResponse)
+        {
+            b0 += db0; b1 += db1; b2 += db2;
+        }
+        else if constexpr (Response == allpassResponse)
+        {
+            b0 += db0; b1 += db1;
+        }
+        else if constexpr (Response != lowpassResponse)
+        {
+            b0 += db0;
+        }
+
+        a1 += da1; a2 += da2;
+
+        // The same sums as the generic kernel's, less the terms that are zero, so the results
+        // are the same values
+        Vector output, update1, update2;
+
+        if constexpr (Response == lowpassResponse)
+        {
+            output = (quarter * a2) * input + s1;                  // b0 == a2 / 4, b1 == b2 == a2
+            update1 = a2 * input + s2;
+            update2 = s2 + a2 * input;
+        }
+        else if constexpr (Response == highpassResponse)
+        {
+            output = b0 * input + s1;                              // b1 == b2 == 0
+            update1 = s2;
+            update2 = s2;
+        }
+        else if constexpr (Response == bandpassResponse)
+        {
+            output = b0 * input + s1;                              // b1 == 2 b0, b2 == 0
+            update1 = (b0 + b0) * input + s2;
+            update2 = s2;
+        }
+        else if constexpr (Response == notchResponse)
+        {
+            output = b0 * input + s1;                              // b1 == b2 == a2
+            update1 = a2 * input + s2;
+            update2 = s2 + a2 * input;
+        }
+        else if constexpr (Response == allpassResponse)
+        {
+            output = b0 * input + s1;                              // b2 == a2
+            update1 = b1 * input + s2;
+            update2 = s2 + a2 * input;
+        }
+        else
+        {
+            output = b0 * input + s1;
+            update1 = b1 * input + s2;
+            update2 = s2 + b2 * input;
+        }
+
+        // Both integrators take this sample's output, so update them from the old s2
+        s1 = (s1 + update1) - a1 * output;
+        s2 = update2 - a2 * output;
+        return output;
+    };
+
+    int i = 0;
+
+    // Four samples at a time: load a 4x4 tile of channels x samples and transpose it
+    // so each register holds one sample of every channel
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        Vector t0 = Vector::load(lane[0] + i), t1 = Vector::load(lane[1] + i);
+        Vector t2 = Vector::load(lane[2] + i), t3 = Vector::load(lane[3] + i);
+        transpose(t0, t1, t2, t3);
+
+        t0 = tick(t0);
+        t1 = tick(t1);
+        t2 = tick(t2);
+        t3 = tick(t3);
+
+        transpose(t0, t1, t2, t3);
+        t0.store(lane[0] + i); t1.store(lane[1] + i);
+        t2.store(lane[2] + i); t3.store(lane[3] + i);
+    }
+
+    for (; i < numSamples; ++i)
+    {
+        alignas(32) SampleType frame[lanes];
+
+        for (int l = 0; l < lanes; ++l)
+            frame[l] = lane[l][i];
+
+        tick(Vector::load(frame)).store(frame);
+
+        for (int l = 0; l < lanes; ++l)
+            lane[l][i] = frame[l];
+    }
+
+    s1.store(group.s1); s2.store(group.s2);
+
+    // Where the ramp got to, with the coefficients the response ties to the free ones, so
+    // a later call picks up from here whichever kernel it runs
+    if constexpr (Response == lowpassResponse)
+    {
+        b0 = quarter * a2; b1 = a2; b2 = a2;
+    }
+    else if constexpr (Response == bandpassResponse)
+    {
+        b1 = b0 + b0;
+    }
+    else if constexpr (Response == notchResponse)
+    {
+        b1 = a2; b2 = a2;
+    }
+    else if constexpr (Response == allpassResponse)
+    {
+        b2 = a2;
+    }
+
+    b0.store(group.b0); b1.store(group.b1); b2.store(group.b2);
+    a1.store(group.a1); a2.store(group.a2);
+}
+
+//==============================================================================
+// Zero-delay-feedback state-variable filters, as described in SvfBank
+template <typename SampleType, int Response>
+void svfKernel(SvfLanes<SampleType>& group, SampleType* const* lane, int numSamples) noexcept
+{
+    using Vector = typename SimdVector<SampleType>::Type;
+    constexpr int lanes = SvfLanes<SampleType>::lanes;
+
+    const Vector one = Vector::broadcast(SampleType(1));
+    const Vector two = Vector::broadcast(SampleType(2));
+
+    Vector g = Vector::load(group.g), k = Vector::load(group.k);
+    Vector m0 = Vector::load(group.m0), m1 = Vector::load(group.m1), m2 = Vector::load(group.m2);
+
+    const Vector dg = Vector::load(group.dg), dk = Vector::load(group.dk);
+    const Vector dm0 = Vector::load(group.dm0), dm1 = Vector::load(group.dm1), dm2 = Vector::load(group.dm2);
+
+    Vector ic1 = Vector::load(group.ic1), ic2 = Vector::load(group.ic2);
+
+    auto tick = [&](Vector input)
+    {
+        g += dg; k += dk;
+
+        if constexpr (Response == genericResponse)
+        {
+            m0 += dm0; m1 += dm1; m2 += dm2;
+        }
+
+        // Solve the zero-delay loop for this sample's g and k
+        const Vector a1 = one / (one + g * (g + k));
+        const Vector a2 = g * a1;
+        const Vector a3 = g * a2;
+
+        const Vector v3 = input - ic2;
+        const Vector v1 = a1 * ic1 + a2 * v3;
+        const Vector v2 = ic2 + a2 * ic1 + a3 * v3;
+
+        ic1 = two * v1 - ic1;
+        ic2 = two * v2 - ic2;
+
+        // The mix designSvf() gives each response, with m1 following k exactly along the ramp
+        if constexpr (Response == lowpassResponse)       return v2;
+        else if constexpr (Response == highpassResponse) return (input - k * v1) - v2;
+        else if constexpr (Response == bandpassResponse) return k * v1;
+        else if constexpr (Response == notchResponse)    return input - k * v1;
+        else if constexpr (Response == allpassResponse)  return input - (k + k) * v1;
+        else                                             return m0 * input + m1 * v1 + m2 * v2;
+    };
+
+    int i = 0;
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        Vector t0 = Vector::load(lane[0] + i), t1 = Vector::load(lane[1] + i);
+        Vector t2 = Vector::load(lane[2] + i), t3 = Vector::load(lane[3] + i);
+        transpose(t0, t1, t2, t3);
+
+        t0 = tick(t0);
+        t1 = tick(t1);
+        t2 = tick(t2);
+        t3 = tick(t3);
+
+        transpose(t0, t1, t2, t3);
+        t0.store(lane[0] + i); t1.store(lane[1] + i);
+        t2.store(lane[2] + i); t3.store(lane[3] + i);
+    }
+
+    for (; i < numSamples; ++i)
+    {
+        alignas(32) SampleType frame[lanes];
+
+        for (int l = 0; l < lanes; ++l)
+            frame[l] = lane[l][i];
+
+        tick(Vector::load(frame)).store(frame);
+
+        for (int l = 0; l < lanes; ++l)
+            lane[l][i] = frame[l];
+    }
+
+    ic1.store(group.ic1); ic2.store(group.ic2);
+
+    // As the biquad kernel does; m0 and m2 are constant along a shaped ramp
+    if constexpr (Response == highpassResponse || Response == notchResponse)
+        m1 = Vector::broadcast(SampleType(0)) - k;
+    else if constexpr (Response == bandpassResponse)
+        m1 = k;
+    else if constexpr (Response == allpassResponse)
+        m1 = Vector::broadcast(SampleType(0)) - (k + k);
+
+    g.store(group.g); k.store(group.k);
+    m0.store(group.m0); m1.store(group.m1); m2.store(group.m2);
+}
+
+//==============================================================================
+template <typename SampleType>
+void mixDryWetKernel(SampleType* wet, const SampleType* dry, const float* mix, int numSamples) noexcept
+{
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        const auto amount = static_cast<SampleType>(mix[sample]);
+        wet[sample] = dry[sample] * (SampleType(1) - amount) + wet[sample] * amount;
+    }
+}
+
+// One tight loop per shape, so the compiler can vectorise each of them
+inline void evaluateWaveformKernel(int waveform, const float* phases, float* out, int numValues) noexcept
+{
+    switch (waveform)
+    {
+        case LFOGenerator::sine:     for (int k = 0; k < numValues; ++k) out[k] = fastSine(phases[k]);      break;
+        case LFOGenerator::triangle: for (int k = 0; k < numValues; ++k) out[k] = triangleShape(phases[k]); break;
+        case LFOGenerator::square:   for (int k = 0; k < numValues; ++k) out[k] = squareShape(phases[k]);   break;
+        case LFOGenerator::saw:      for (int k = 0; k < numValues; ++k) out[k] = sawShape(phases[k]);      break;
+        default:                     for (int k = 0; k < numValues; ++k) out[k] = 0.0f;                     break;
+    }
+}
+
+inline void mapToCutoffKernel(const float* lfoValues, const float* depthValues, const float* baseFrequencies,
+                              float* cutoffs, int numValues) noexcept
+{
+    constexpr float octavesAtFullDepth = ModulationMapper::octavesAtFullDepth;
+    constexpr float minCutoff = ModulationMapper::minCutoff;
+    constexpr float maxCutoff = ModulationMapper::maxCutoff;
+
+    const Float4 octaves = Float4::broadcast(octavesAtFullDepth);
+    const Float4 lowest = Float4::broadcast(minCutoff);
+    const Float4 highest = Float4::broadcast(maxCutoff);
+
+    int i = 0;
+
+    for (; i + 4 <= numValues; i += 4)
+    {
+        const Float4 exponent = Float4::load(lfoValues + i) * Float4::load(depthValues + i) * octaves;
+        min(highest, max(lowest, Float4::load(baseFrequencies + i) * fastExp2(exponent))).store(cutoffs + i);
+    }
+
+    for (; i < numValues; ++i)
+    {
+        const float cutoff = baseFrequencies[i] * fastExp2(lfoValues[i] * depthValues[i] * octavesAtFullDepth);
+        const float clamped = minCutoff < cutoff ? cutoff : minCutoff;
+        cutoffs[i] = clamped < maxCutoff ? clamped : maxCutoff;
+    }
+}
+
+inline void scaleByOctavesKernel(float* values, const float* offsets, float octavesAtFullScale,
+                                 float lowest, float highest, int numValues) noexcept
+{
+    const Float4 octaves = Float4::broadcast(octavesAtFullScale);
+    const Float4 low = Float4::broadcast(lowest);
+    const Float4 high = Float4::broadcast(highest);
+
+    int i = 0;
+
+    for (; i + 4 <= numValues; i += 4)
+        min(high, max(low, Float4::load(values + i) * fastExp2(Float4::load(offsets + i) * octaves))).store(values + i);
+
+    for (; i < numValues; ++i)
+    {
+        const float scaled = values[i] * fastExp2(offsets[i] * octavesAtFullScale);
+        const float clamped = lowest < scaled ? scaled : lowest;
+        values[i] = clamped < highest ? clamped : highest;
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+constexpr SampleKernels<SampleType> makeSampleKernels() noexcept
+{
+    return { { &biquadKernel<SampleType, lowpassResponse>,
+               &biquadKernel<SampleType, highpassResponse>,
+               &biquadKernel<SampleType, bandpassResponse>,
+               &biquadKernel<SampleType, notchResponse>,
+               &biquadKernel<SampleType, allpassResponse>,
+               &biquadKernel<SampleType, genericResponse> },
+             { &svfKernel<SampleType, lowpassResponse>,
+               &svfKernel<SampleType, highpassResponse>,
+               &svfKernel<SampleType, bandpassResponse>,
+               &svfKernel<SampleType, notchResponse>,
+               &svfKernel<SampleType, allpassResponse>,
+               &svfKernel<SampleType, genericResponse> },
+             &mixDryWetKernel<SampleType> };
+}
+
+constexpr KernelSet makeKernelSet(const char* name) noexcept
+{
+    return { name,
+             makeSampleKernels<float>(),
+             makeSampleKernels<double>(),
+             &evaluateWaveformKernel,
+             &mapToCutoffKernel,
+             &scaleByOctavesKernel };
+}
+
+} // namespace FLARKSIESIS_ISA
+} // namespace flarksiesis
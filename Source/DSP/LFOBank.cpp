@@ -0,0 +1,127 @@
+#include "LFOBank.h"
+#include "LFOGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace flarksiesis
+{
+
+void LFOBank::prepare(int maxPointsPerBlock)
+{
+    const int floatsPerLine = static_cast<int>(cacheLineSize / sizeof(float));
+    maxPoints = (std::max(1, maxPointsPerBlock) + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+
+    values.assign(static_cast<size_t>(numLFOs * maxPoints), 0.0f);
+    pointPhases.assign(static_cast<size_t>(maxPoints), 0.0f);
+
+    reset();
+}
+
+void LFOBank::reset() noexcept
+{
+    // Lane 0 starts where LFOGenerator does; the others get their own sequences
+    static constexpr std::array<std::uint32_t, numLFOs> seeds { 0x2545f491u, 0x9e3779b9u, 0x6c078965u, 0x41c64e6du };
+
+    phases.fill(0.0);
+    increments.fill(0.0);
+    samplesSinceAnchor.fill(0);
+    randomStates = seeds;
+
+    for (int lfo = 0; lfo < numLFOs; ++lfo)
+        for (size_t i = 0; i < randomWindows.size(); ++i)
+            shiftRandomWindow(lfo);
+}
+
+void LFOBank::shiftRandomWindow(int lfo) noexcept
+{
+    const auto lane = static_cast<size_t>(lfo);
+    auto& state = randomStates[lane];
+
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+
+    randomWindows[0][lane] = randomWindows[1][lane];
+    randomWindows[1][lane] = randomWindows[2][lane];
+    randomWindows[2][lane] = randomWindows[3][lane];
+    randomWindows[3][lane] = static_cast<float>(state >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+//==============================================================================
+void LFOBank::moveAnchor(int lfo, std::int64_t numSamples) noexcept
+{
+    const auto lane = static_cast<size_t>(lfo);
+    const double p = phases[lane] + increments[lane] * static_cast<double>(numSamples);
+    const double cycles = std::floor(p);
+
+    for (double cycle = 0.0; cycle < cycles; cycle += 1.0)
+        shiftRandomWindow(lfo);
+
+    phases[lane] = p - cycles;
+    samplesSinceAnchor[lane] -= numSamples;
+}
+
+void LFOBank::setIncrement(int lfo, double phaseIncrement) noexcept
+{
+    const auto lane = static_cast<size_t>(lfo);
+
+    if (phaseIncrement != increments[lane])
+    {
+        moveAnchor(lfo, samplesSinceAnchor[lane]);
+        increments[lane] = phaseIncrement;
+    }
+}
+
+int LFOBank::render(const int* waveforms, const double* phaseIncrements, int numSamples, int firstPoint,
+                    int stride) noexcept
+{
+    stride = std::max(1, stride);
+    const int numPoints = std::min(maxPoints, LFOGenerator::countPoints(numSamples, firstPoint, stride));
+
+    for (int lfo = 0; lfo < numLFOs; ++lfo)
+    {
+        const auto lane = static_cast<size_t>(lfo);
+        const bool isRandom = waveforms[lfo] == LFOGenerator::random;
+        float* out = values.data() + lfo * maxPoints;
+        float* phasesAtPoints = pointPhases.data();
+
+        setIncrement(lfo, phaseIncrements[lfo]);
+
+        // Anchored on every point, as in LFOGenerator
+        for (int k = 0; k < numPoints; ++k)
+        {
+            moveAnchor(lfo, samplesSinceAnchor[lane] + firstPoint + k * stride);
+            phasesAtPoints[k] = static_cast<float>(phases[lane]);
+
+            if (isRandom)
+            {
+                const float from = randomWindows[1][lane];
+                const float to = randomWindows[2][lane];
+                out[k] = from + (to - from) * phasesAtPoints[k];
+            }
+        }
+
+        if (! isRandom)
+            LFOGenerator::evaluateBlock(waveforms[lfo], phasesAtPoints, out, numPoints);
+
+        samplesSinceAnchor[lane] += numSamples;
+    }
+
+    return numPoints;
+}
+
+void LFOBank::advance(const double* phaseIncrements, int numSamples) noexcept
+{
+    for (int lfo = 0; lfo < numLFOs; ++lfo)
+    {
+        const auto lane = static_cast<size_t>(lfo);
+
+        setIncrement(lfo, phaseIncrements[lfo]);
+
+        if ((samplesSinceAnchor[lane] += numSamples) >= LFOGenerator::maxSamplesBetweenAnchors)
+            moveAnchor(lfo, samplesSinceAnchor[lane]);
+    }
+}
+
+} // namespace flarksiesis
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "AlignedVector.h"
+
+#include <array>
+#include <cstdint>
+
+namespace flarksiesis
+{
+
+//==============================================================================
+/**
+    The LFOs feeding the modulation matrix, as a structure of arrays: every
+    piece of state (phase, random generator, random values) is an array with
+    one lane per LFO, and the output is one row of control-point values per
+    LFO. Each row is rendered by the same vectorisable shape loops as
+    LFOGenerator, so all of them together cost a few operations per control
+    point, not per sample.
+
+    Lane 0 follows the main LFO: with the same waveform and phase increment it
+    runs the same phase arithmetic and random sequence as LFOGenerator's first
+    channel, without waiting for its stereo spread. Lanes 1 to 3 are LFOs 2 to 4.
+*/
+class LFOBank
+{
+public:
+    static constexpr int numLFOs = 4;
+
+    void prepare(int maxPointsPerBlock);
+    void reset() noexcept;
+
+    /** Renders every LFO at the control points that fall in numSamples samples (samples
+        firstPoint, firstPoint + stride and so on, as in LFOGenerator) and advances them.
+        waveforms and phaseIncrements hold one entry per LFO. Returns the number of points per LFO.
+    */
+    int render(const int* waveforms, const double* phaseIncrements, int numSamples, int firstPoint,
+               int stride) noexcept;
+
+    /** Moves on by numSamples without rendering, as render() would have. */
+    void advance(const double* phaseIncrements, int numSamples) noexcept;
+
+    const float* getValues(int lfo) const noexcept { return values.data() + lfo * maxPoints; }
+
+private:
+    void shiftRandomWindow(int lfo) noexcept;
+    void moveAnchor(int lfo, std::int64_t numSamples) noexcept;
+    void setIncrement(int lfo, double phaseIncrement) noexcept;
+
+    AlignedVector<float> values;      // [lfo][point]
+    AlignedVector<float> pointPhases; // Scratch: one LFO's phase per point
+    int maxPoints = 0;
+
+    // Each phase is held at an anchor and moved on by whole samples, as in LFOGenerator
+    std::array<double, numLFOs> phases {};
+    std::array<double, numLFOs> increments {};
+    std::array<std::int64_t, numLFOs> samplesSinceAnchor {};
+    std::array<std::uint32_t, numLFOs> randomStates {};
+
+    // Random values for the previous, current, next and following cycle, per LFO
+    std::array<std::array<float, numLFOs>, 4> randomWindows {};
+};
+
+} // namespace flarksiesis
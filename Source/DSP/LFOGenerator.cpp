@@ -0,0 +1,154 @@
+#include "LFOGenerator.h"
+#include "Kernels.h"
+
+namespace flarksiesis
+{
+
+//==============================================================================
+void LFOGenerator::prepare(int numChannels, int maxPointsPerBlock)
+{
+    numChannels = std::max(1, numChannels);
+    // Rows padded to whole cache lines, so each channel's values start on their own line
+    const int floatsPerLine = static_cast<int>(cacheLineSize / sizeof(float));
+    maxPoints = (std::max(1, maxPointsPerBlock) + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+
+    values.assign(static_cast<size_t>(numChannels * maxPoints), 0.0f);
+    pointPhases.assign(static_cast<size_t>(maxPoints), 0.0f);
+    channelPhase.assign(static_cast<size_t>(maxPoints), 0.0f);
+
+    channelSpread.resize(static_cast<size_t>(numChannels));
+    for (int channel = 0; channel < numChannels; ++channel)
+        channelSpread[static_cast<size_t>(channel)] = numChannels > 1 ? static_cast<float>(channel) / static_cast<float>(numChannels - 1)
+                                                                      : 0.0f;
+
+    reset();
+}
+
+void LFOGenerator::reset() noexcept
+{
+    phase = 0.0;
+    increment = 0.0;
+    samplesSinceAnchor = 0;
+    randomState = 0x2545f491u;
+
+    for (int i = 0; i < static_cast<int>(randomWindow.size()); ++i)
+        shiftRandomWindow();
+}
+
+void LFOGenerator::shiftRandomWindow() noexcept
+{
+    // xorshift32; the sequence only has to sound random, and must not allocate or lock
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+
+    randomWindow[0] = randomWindow[1];
+    randomWindow[1] = randomWindow[2];
+    randomWindow[2] = randomWindow[3];
+    randomWindow[3] = static_cast<float>(randomState >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+//==============================================================================
+void LFOGenerator::moveAnchor(std::int64_t numSamples) noexcept
+{
+    const double p = phase + increment * static_cast<double>(numSamples);
+    const double cycles = std::floor(p);
+
+    for (double cycle = 0.0; cycle < cycles; cycle += 1.0)
+        shiftRandomWindow();
+
+    phase = p - cycles;
+    samplesSinceAnchor -= numSamples;
+}
+
+void LFOGenerator::setIncrement(double phaseIncrement) noexcept
+{
+    if (phaseIncrement != increment)
+    {
+        moveAnchor(samplesSinceAnchor);
+        increment = phaseIncrement;
+    }
+}
+
+int LFOGenerator::render(int waveform, double phaseIncrement, int numSamples, int firstPoint, int stride,
+                         const float* phaseOffsets) noexcept
+{
+    stride = std::max(1, stride);
+    const int numPoints = std::min(maxPoints, countPoints(numSamples, firstPoint, stride));
+
+    setIncrement(phaseIncrement);
+
+    for (int k = 0; k < numPoints; ++k)
+    {
+        // Every point becomes the anchor, so its phase is the last point's plus whole samples
+        moveAnchor(samplesSinceAnchor + firstPoint + k * stride);
+        pointPhases[static_cast<size_t>(k)] = static_cast<float>(phase);
+
+        if (waveform != random)
+            continue;
+
+        for (int channel = 0; channel < getNumChannels(); ++channel)
+        {
+            const float offset = phaseOffsets != nullptr ? phaseOffsets[k] * channelSpread[static_cast<size_t>(channel)] : 0.0f;
+            const float q = pointPhases[static_cast<size_t>(k)] + offset;
+            const int cycle = std::clamp(static_cast<int>(std::floor(q)), -1, 1);
+            const float fraction = q - static_cast<float>(cycle);
+
+            const float from = randomWindow[static_cast<size_t>(cycle + 1)];
+            const float to = randomWindow[static_cast<size_t>(cycle + 2)];
+            values[static_cast<size_t>(channel * maxPoints + k)] = from + (to - from) * fraction;
+        }
+    }
+
+    if (waveform != random)
+    {
+        for (int channel = 0; channel < getNumChannels(); ++channel)
+        {
+            const float spread = channelSpread[static_cast<size_t>(channel)];
+            const float* source = pointPhases.data();
+            float* phases = channelPhase.data();
+            float* out = values.data() + channel * maxPoints;
+
+            if (phaseOffsets != nullptr && spread != 0.0f)
+            {
+                for (int k = 0; k < numPoints; ++k)
+                {
+                    phases[k] = wrapPhase(source[k] + phaseOffsets[k] * spread);
+                }
+                source = phases;
+            }
+
+            evaluateBlock(waveform, source, out, numPoints);
+        }
+    }
+
+    samplesSinceAnchor += numSamples;
+    return numPoints;
+}
+
+void LFOGenerator::advance(double phaseIncrement, int numSamples) noexcept
+{
+    setIncrement(phaseIncrement);
+
+    if ((samplesSinceAnchor += numSamples) >= maxSamplesBetweenAnchors)
+        moveAnchor(samplesSinceAnchor);
+}
+
+void LFOGenerator::evaluateBlock(int waveform, const float* phases, float* out, int numValues) noexcept
+{
+    getKernels().evaluateWaveform(waveform, phases, out, numValues);
+}
+
+float LFOGenerator::evaluate(int waveform, float phase) noexcept
+{
+    switch (waveform)
+    {
+        case sine:     return fastSine(phase);
+        case triangle: return triangleShape(phase);
+        case square:   return squareShape(phase);
+        case saw:      return sawShape(phase);
+        default:       return 0.0f;
+    }
+}
+
+} // namespace flarksiesis
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "AlignedVector.h"
+#include "LFOShapes.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace flarksiesis
+{
+
+//==============================================================================
+/**
+    Renders the modulation LFO for a whole block at once, one value per control
+    point, for every channel.
+
+    Point k sits on sample firstPoint + k * stride of the block: the control
+    points are on a grid that runs across blocks, and the caller says where the
+    first one falls in this block, so the values don't depend on how the host
+    splits the stream. The phase is double precision, and is only ever moved
+    on by a whole number of samples from an anchor: the last point, or where
+    the rate last changed. Both fall on the grid, so a point's phase doesn't
+    depend on the blocks in between, and long sessions at low rates don't drift.
+    Channels are derived from the same pass by a phase offset: channel c is
+    shifted by c / (numChannels - 1) times the per-point offset passed to
+    render(), so with two channels the right one gets the whole offset.
+
+    The waveform indices match flarksiesis::LFOWaveform.
+*/
+class LFOGenerator
+{
+public:
+    enum Waveform
+    {
+        sine = 0,
+        triangle,
+        square,
+        saw,
+        random
+    };
+
+    void prepare(int numChannels, int maxPointsPerBlock);
+    void reset() noexcept;
+
+    int getNumChannels() const noexcept { return static_cast<int>(channelSpread.size()); }
+    double getPhase() const noexcept
+    {
+        const double p = phase + increment * static_cast<double>(samplesSinceAnchor);
+        return p - std::floor(p);
+    }
+
+    /** Renders the points that fall in numSamples samples and advances the phase by numSamples.
+        phaseOffsets holds one offset (in cycles, within +-0.5) per point, or is nullptr.
+        Returns the number of points written per channel, which may be zero.
+    */
+    int render(int waveform, double phaseIncrement, int numSamples, int firstPoint, int stride,
+               const float* phaseOffsets) noexcept;
+
+    /** How many points of a grid starting at firstPoint fall in numSamples samples. */
+    static int countPoints(int numSamples, int firstPoint, int stride) noexcept
+    {
+        return firstPoint < numSamples ? (numSamples - firstPoint + stride - 1) / stride : 0;
+    }
+
+    /** Moves on by numSamples without rendering, as render() would have. The anchor stays
+        put until it is maxSamplesBetweenAnchors behind, so stretches without points don't
+        cost the points after them their exact phase, and the phase never gets far from it.
+    */
+    void advance(double phaseIncrement, int numSamples) noexcept;
+    static constexpr std::int64_t maxSamplesBetweenAnchors = 1 << 16;
+
+    const float* getValues(int channel) const noexcept { return values.data() + channel * maxPoints; }
+
+    /** The deterministic shapes at a phase in [0, 1); random reads as zero. */
+    static float evaluate(int waveform, float phase) noexcept;
+
+    /** evaluate() over a block of phases, as one vectorisable loop per shape, through
+        the kernels getKernels() chose for this CPU.
+    */
+    static void evaluateBlock(int waveform, const float* phases, float* out, int numValues) noexcept;
+
+    /** Wraps a phase in [-1, 2) into [0, 1). Comparisons only, no float-to-int
+        conversion, so loops using it vectorise without fast-math.
+    */
+    static inline float wrapPhase(float phase) noexcept
+    {
+        return phase + (phase < 0.0f ? 1.0f : 0.0f) + (phase < 1.0f ? 0.0f : -1.0f);
+    }
+
+private:
+    void shiftRandomWindow() noexcept;
+    void moveAnchor(std::int64_t numSamples) noexcept; // To numSamples past the anchor
+    void setIncrement(double phaseIncrement) noexcept;
+
+    AlignedVector<float> values;       // [channel][point]
+    AlignedVector<float> pointPhases;  // Scratch: master phase per point
+    AlignedVector<float> channelPhase; // Scratch: one channel's phase per point
+    AlignedVector<float> channelSpread;
+    int maxPoints = 0;
+
+    double phase = 0.0;                  // At the anchor, in [0, 1)
+    double increment = 0.0;              // Since the anchor
+    std::int64_t samplesSinceAnchor = 0; // To the start of the next block
+
+    // Random values for the previous, current, next and following cycle of the
+    // master phase, so offset channels can interpolate without their own state
+    std::array<float, 4> randomWindow {};
+    std::uint32_t randomState = 0x2545f491u;
+};
+
+} // namespace flarksiesis
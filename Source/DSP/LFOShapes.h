@@ -0,0 +1,49 @@
+#pragma once
+
+#include "SimdFloat4.h"
+
+namespace flarksiesis
+{
+inline namespace FLARKSIESIS_ISA
+{
+
+//==============================================================================
+// The deterministic LFO shapes at a phase in [0, 1). Written with comparisons rather than
+// std::min and friends, as they are also built into the per-instruction-set kernels
+// (see SimdFloat4.h).
+
+inline float triangleShape(float phase) noexcept
+{
+    // Rises from 0 to 1, falls to -1 and returns to 0; written without branches
+    const float t = phase * 4.0f;
+    const float peak = (2.0f - t) < t ? 2.0f - t : t;
+    return peak < t - 4.0f ? t - 4.0f : peak;
+}
+
+inline float squareShape(float phase) noexcept
+{
+    return phase < 0.5f ? 1.0f : -1.0f;
+}
+
+inline float sawShape(float phase) noexcept
+{
+    return 2.0f * phase - 1.0f;
+}
+
+// sin (2 pi phase) for a phase in [0, 1), within 2e-7 of std::sin
+inline float fastSine(float phase) noexcept
+{
+    // sin (2 pi p) = -sin (2 pi (p - 0.5)); fold that onto [0, 0.25], where an
+    // odd polynomial fits to float precision
+    const float x = phase - 0.5f;
+    const float a = x < 0.0f ? -x : x;
+    const float folded = (0.5f - a) < a ? 0.5f - a : a;
+    const float x2 = folded * folded;
+
+    const float poly = folded * (6.28318516f + x2 * (-41.3416550f + x2 * (81.6010046f
+                               + x2 * (-76.5497924f + x2 * 39.5367742f))));
+    return x < 0.0f ? poly : -poly;
+}
+
+} // namespace FLARKSIESIS_ISA
+} // namespace flarksiesis
@@ -0,0 +1,19 @@
+#include "ModulationMapper.h"
+#include "Kernels.h"
+
+namespace flarksiesis
+{
+
+void ModulationMapper::mapToCutoff(const float* lfoValues, const float* depthValues, const float* baseFrequencies,
+                                   float* cutoffs, int numValues) noexcept
+{
+    getKernels().mapToCutoff(lfoValues, depthValues, baseFrequencies, cutoffs, numValues);
+}
+
+void ModulationMapper::scaleByOctaves(float* values, const float* offsets, float octavesAtFullScale,
+                                      float lowest, float highest, int numValues) noexcept
+{
+    getKernels().scaleByOctaves(values, offsets, octavesAtFullScale, lowest, highest, numValues);
+}
+
+} // namespace flarksiesis
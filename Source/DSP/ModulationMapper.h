@@ -0,0 +1,33 @@
+#pragma once
+
+namespace flarksiesis
+{
+
+//==============================================================================
+/**
+    Turns a block of LFO values into filter cutoffs.
+
+    cutoff = clamp (base * 2^(lfo * depth * octavesAtFullDepth), minCutoff, maxCutoff)
+
+    The exponential is fastExp2() from SimdFloat4.h, four values at a time, in
+    place of std::pow. Its error stays below 0.00035 cents over the whole range.
+    The loops are kernels (see Kernels.h), built once per instruction set.
+*/
+struct ModulationMapper
+{
+    static constexpr float octavesAtFullDepth = 4.0f;
+    static constexpr float minCutoff = 20.0f;
+    static constexpr float maxCutoff = 20000.0f;
+
+    /** depthValues and baseFrequencies hold one value per LFO value. cutoffs may not alias the inputs. */
+    static void mapToCutoff(const float* lfoValues, const float* depthValues, const float* baseFrequencies,
+                            float* cutoffs, int numValues) noexcept;
+
+    /** values[i] = clamp (values[i] * 2^(offsets[i] * octavesAtFullScale), lowest, highest), in place.
+        For modulating a parameter in the log domain, such as the base cutoff or the resonance.
+    */
+    static void scaleByOctaves(float* values, const float* offsets, float octavesAtFullScale,
+                               float lowest, float highest, int numValues) noexcept;
+};
+
+} // namespace flarksiesis
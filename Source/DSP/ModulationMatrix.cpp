@@ -0,0 +1,114 @@
+#include "ModulationMatrix.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace flarksiesis
+{
+
+void ModulationMatrix::prepare(int maxPointsPerBlock)
+{
+    const int floatsPerLine = static_cast<int>(cacheLineSize / sizeof(float));
+    maxPoints = (std::max(1, maxPointsPerBlock) + floatsPerLine - 1) / floatsPerLine * floatsPerLine;
+
+    offsets.assign(static_cast<size_t>(numTargets * maxPoints), 0.0f);
+    reset();
+}
+
+void ModulationMatrix::reset() noexcept
+{
+    std::fill(offsets.begin(), offsets.end(), 0.0f);
+    rampFrom.fill(0.0f);
+    rampTo.fill(0.0f);
+}
+
+void ModulationMatrix::setRoute(int index, int source, int target, float depth) noexcept
+{
+    if (index < 0 || index >= numRoutes)
+        return;
+
+    const bool valid = source >= 0 && source < LFOBank::numLFOs && target >= 0 && target < numTargets;
+    routes[static_cast<size_t>(index)] = valid ? Route { source, target, depth } : Route {};
+
+    targeted.fill(false);
+    numActiveRoutes = 0;
+
+    for (const auto& route : routes)
+    {
+        if (route.depth != 0.0f)
+        {
+            targeted[static_cast<size_t>(route.target)] = true;
+            ++numActiveRoutes;
+        }
+    }
+}
+
+//==============================================================================
+void ModulationMatrix::process(const LFOBank& bank, int numPoints) noexcept
+{
+    numPoints = std::min(numPoints, maxPoints);
+
+    for (int target = 0; target < numTargets; ++target)
+    {
+        if (! targeted[static_cast<size_t>(target)])
+        {
+            // Ramps start from zero again when a target is routed later on
+            rampFrom[static_cast<size_t>(target)] = rampTo[static_cast<size_t>(target)] = 0.0f;
+            continue;
+        }
+
+        float* out = offsets.data() + target * maxPoints;
+        std::fill(out, out + numPoints, 0.0f);
+
+        for (const auto& route : routes)
+        {
+            if (route.target != target || route.depth == 0.0f)
+                continue;
+
+            const float* in = bank.getValues(route.source);
+            const float depth = route.depth;
+
+            for (int k = 0; k < numPoints; ++k)
+                out[k] += in[k] * depth;
+        }
+    }
+}
+
+void ModulationMatrix::applyToPoints(int target, float* values, int numPoints, float scale,
+                                     float lowest, float highest) const noexcept
+{
+    const float* in = getOffsets(target);
+
+    for (int k = 0; k < numPoints; ++k)
+        values[k] = std::min(highest, std::max(lowest, values[k] + scale * in[k]));
+}
+
+void ModulationMatrix::applyToRamp(int target, float* ramp, int numSamples, int firstPoint, int stride,
+                                   float scale, float lowest, float highest) noexcept
+{
+    const float* in = getOffsets(target);
+    float& rampStart = rampFrom[static_cast<size_t>(target)];
+    float& rampEnd = rampTo[static_cast<size_t>(target)];
+
+    // Sample i of a stride gets the same value whichever call it falls in
+    auto applySegment = [&](float* out, int firstIndex, int length)
+    {
+        const float from = scale * rampStart;
+        const float step = (scale * rampEnd - from) / static_cast<float>(stride);
+
+        for (int i = 0; i < length; ++i)
+            out[i] = std::min(highest, std::max(lowest, out[i] + from + step * static_cast<float>(firstIndex + i + 1)));
+    };
+
+    const int carried = std::min(firstPoint, numSamples);
+    applySegment(ramp, stride - firstPoint, carried);
+
+    for (int start = firstPoint, point = 0; start < numSamples; start += stride, ++point)
+    {
+        rampStart = rampEnd;
+        rampEnd = in[point];
+        applySegment(ramp + start, 0, std::min(stride, numSamples - start));
+    }
+}
+
+} // namespace flarksiesis
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "AlignedVector.h"
+#include "LFOBank.h"
+
+#include <array>
+
+namespace flarksiesis
+{
+
+//==============================================================================
+/**
+    Routes the LFOs of an LFOBank to the continuous parameters. Each route adds
+    its LFO times its depth (-1 to 1) to one target, and routes to the same
+    target add up. process() turns that into one row of offsets per target, one
+    per control point, with a multiply-add over whole LFO rows per route.
+
+    Offsets are in units of the target's full modulation range; the caller
+    scales them and applies them to its control points or per-sample ramps.
+    Targets that no route reaches are left at zero.
+*/
+class ModulationMatrix
+{
+public:
+    enum Target
+    {
+        cutoff = 0,
+        resonance,
+        mix,
+        stereoWidth,
+        feedback,
+        numTargets
+    };
+
+    static constexpr int numRoutes = 4;
+
+    void prepare(int maxPointsPerBlock);
+    void reset() noexcept;
+
+    /** Replaces the routes; a depth of 0 (or an out-of-range source or target) disables that route. */
+    void setRoute(int index, int source, int target, float depth) noexcept;
+
+    bool isActive() const noexcept { return numActiveRoutes > 0; }
+    bool isTargeted(int target) const noexcept { return targeted[static_cast<size_t>(target)]; }
+
+    /** Fills the offset rows from the bank's first numPoints values. */
+    void process(const LFOBank& bank, int numPoints) noexcept;
+
+    const float* getOffsets(int target) const noexcept { return offsets.data() + target * maxPoints; }
+
+    /** values[i] = clamp (values[i] + scale * offset[i], lowest, highest), for control-point rows. */
+    void applyToPoints(int target, float* values, int numPoints, float scale, float lowest, float highest) const noexcept;
+
+    /** The same for a per-sample ramp, with the offsets interpolated linearly over the 'stride'
+        samples from each control point to the next, as the filter coefficients are. Samples
+        before firstPoint finish the ramp an earlier call started.
+    */
+    void applyToRamp(int target, float* ramp, int numSamples, int firstPoint, int stride,
+                     float scale, float lowest, float highest) noexcept;
+
+private:
+    struct Route
+    {
+        int source = 0;
+        int target = 0;
+        float depth = 0.0f;
+    };
+
+    std::array<Route, numRoutes> routes {};
+    std::array<bool, numTargets> targeted {};
+    std::array<float, numTargets> rampFrom {}, rampTo {}; // The offsets the ramp in progress joins
+    int numActiveRoutes = 0;
+
+    AlignedVector<float> offsets; // [target][point]
+    int maxPoints = 0;
+};
+
+} // namespace flarksiesis
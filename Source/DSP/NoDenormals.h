@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+ #include <xmmintrin.h>
+ #define FLARKSIESIS_DENORMALS_MXCSR 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+ #define FLARKSIESIS_DENORMALS_FPCR 1
+#endif
+
+namespace flarksiesis
+{
+
+//==============================================================================
+/**
+    Flushes denormals to zero on this thread for as long as it exists, and
+    restores the previous mode afterwards: flush-to-zero and denormals-are-zero
+    in MXCSR on x86, flush-to-zero in FPCR on AArch64. Decaying filter state
+    would otherwise crawl through denormals at many times the normal cost.
+    Elsewhere it does nothing.
+*/
+class ScopedNoDenormals
+{
+public:
+    ScopedNoDenormals() noexcept
+    {
+       #if FLARKSIESIS_DENORMALS_MXCSR
+        previous = _mm_getcsr();
+        _mm_setcsr(static_cast<unsigned int>(previous | 0x8040u));
+       #elif FLARKSIESIS_DENORMALS_FPCR
+        __asm__ __volatile__ ("mrs %0, fpcr" : "=r" (previous));
+        const std::uint64_t flushToZero = previous | (1u << 24);
+        __asm__ __volatile__ ("msr fpcr, %0" : : "r" (flushToZero));
+       #endif
+    }
+
+    ~ScopedNoDenormals() noexcept
+    {
+       #if FLARKSIESIS_DENORMALS_MXCSR
+        _mm_setcsr(static_cast<unsigned int>(previous));
+       #elif FLARKSIESIS_DENORMALS_FPCR
+        __asm__ __volatile__ ("msr fpcr, %0" : : "r" (previous));
+       #endif
+    }
+
+    ScopedNoDenormals(const ScopedNoDenormals&) = delete;
+    ScopedNoDenormals& operator=(const ScopedNoDenormals&) = delete;
+
+private:
+    [[maybe_unused]] std::uint64_t previous = 0;
+};
+
+} // namespace flarksiesis
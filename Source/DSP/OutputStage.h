@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Kernels.h"
+
+namespace flarksiesis
+{
+
+//==============================================================================
+/**
+    The last two steps of the signal chain, after the filter: feedback and the
+    dry/wet mix. Both take per-sample parameter ramps, which are always float;
+    the audio is float or double.
+*/
+struct OutputStage
+{
+    // wet[n] += wet[n - 1] * feedback[n]. 'previous' is the wet sample before the block, and is
+    // left at its last one, so the recursion runs on across blocks.
+    template <typename SampleType>
+    static void applyFeedback(SampleType* wet, const float* feedback, int numSamples, SampleType& previous) noexcept
+    {
+        for (int sample = 0; sample < numSamples; ++sample)
+            previous = wet[sample] += previous * static_cast<SampleType>(feedback[sample]);
+    }
+
+    // wet[n] = dry[n] * (1 - mix[n]) + wet[n] * mix[n], through the kernels for this CPU
+    template <typename SampleType>
+    static void mixDryWet(SampleType* wet, const SampleType* dry, const float* mix, int numSamples) noexcept
+    {
+        getKernels().forSampleType<SampleType>().mixDryWet(wet, dry, mix, numSamples);
+    }
+};
+
+} // namespace flarksiesis
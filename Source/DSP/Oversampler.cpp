@@ -0,0 +1,253 @@
+#include "Oversampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace flarksiesis
+{
+
+namespace
+{
+    // Zeroth-order modified Bessel function of the first kind, for the Kaiser window
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; k < 64 && term > 1.0e-12 * sum; ++k)
+        {
+            const double half = x / (2.0 * k);
+            term *= half * half;
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    // Oversampling stages: half order, i.e. 4 * halfOrder + 3 taps, and the Kaiser window's stopband target
+    constexpr int firstStageHalfOrder = 23;
+    constexpr int secondStageHalfOrder = 5;
+    constexpr double stageAttenuationDb = 80.0;
+}
+
+//==============================================================================
+template <typename SampleType>
+void HalfBandFilter<SampleType>::prepare(int newHalfOrder, double attenuationDb, int numChannels, int maxLowRateSamples)
+{
+    halfOrder = std::max(0, newHalfOrder);
+    numTaps = 2 * halfOrder + 2;
+    const int maxSamples = std::max(1, maxLowRateSamples);
+
+    // Kaiser-windowed sinc with its cutoff at a quarter of the high rate
+    const int length = 4 * halfOrder + 3;
+    const int centre = 2 * halfOrder + 1;
+    const double beta = attenuationDb > 50.0 ? 0.1102 * (attenuationDb - 8.7)
+                                             : 0.5842 * std::pow(attenuationDb - 21.0, 0.4) + 0.07886 * (attenuationDb - 21.0);
+    const double pi = 3.14159265358979323846;
+
+    std::vector<double> designed(static_cast<size_t>(numTaps));
+    double sum = 0.0;
+
+    for (int i = 0; i < numTaps; ++i)
+    {
+        const double offset = 2 * i - centre;
+        const double position = 2.0 * (2 * i) / (length - 1) - 1.0;
+        const double window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - position * position))) / besselI0(beta);
+
+        designed[static_cast<size_t>(i)] = std::sin(pi * offset / 2.0) / (pi * offset) * window;
+        sum += designed[static_cast<size_t>(i)];
+    }
+
+    // The centre tap is 0.5; scale the rest to 0.5 as well for exact unity gain at DC
+    taps.resize(static_cast<size_t>(numTaps));
+    for (int i = 0; i < numTaps; ++i)
+        taps[static_cast<size_t>(i)] = static_cast<SampleType>(designed[static_cast<size_t>(i)] * 0.5 / sum);
+
+    const auto history = static_cast<size_t>(numTaps - 1);
+    upHistory.assign(history * static_cast<size_t>(numChannels), SampleType(0));
+    downEvenHistory.assign(history * static_cast<size_t>(numChannels), SampleType(0));
+    downOddHistory.assign(static_cast<size_t>(halfOrder + 1) * static_cast<size_t>(numChannels), SampleType(0));
+
+    evenScratch.assign(history + static_cast<size_t>(maxSamples), SampleType(0));
+    oddScratch.assign(static_cast<size_t>(halfOrder + 1 + maxSamples), SampleType(0));
+    accumulator.assign(static_cast<size_t>(maxSamples), SampleType(0));
+}
+
+template <typename SampleType>
+void HalfBandFilter<SampleType>::reset() noexcept
+{
+    std::fill(upHistory.begin(), upHistory.end(), SampleType(0));
+    std::fill(downEvenHistory.begin(), downEvenHistory.end(), SampleType(0));
+    std::fill(downOddHistory.begin(), downOddHistory.end(), SampleType(0));
+}
+
+template <typename SampleType>
+void HalfBandFilter<SampleType>::upsample(int channel, const SampleType* input, SampleType* output, int numSamples) noexcept
+{
+    const int history = numTaps - 1;
+    SampleType* const stateData = upHistory.data() + channel * history;
+    SampleType* const s = evenScratch.data();
+    SampleType* const acc = accumulator.data();
+
+    std::copy(stateData, stateData + history, s);
+    std::copy(input, input + numSamples, s + history);
+    std::fill(acc, acc + numSamples, SampleType(0));
+
+    // Tap-outer order keeps the inner loop a plain multiply-add across samples, which vectorises
+    for (int i = 0; i < numTaps; ++i)
+    {
+        const SampleType tap = SampleType(2) * taps[static_cast<size_t>(i)];
+        const SampleType* source = s + history - i;
+
+        for (int m = 0; m < numSamples; ++m)
+            acc[m] += tap * source[m];
+    }
+
+    const SampleType* delayed = s + history - halfOrder;
+
+    for (int m = 0; m < numSamples; ++m)
+    {
+        output[2 * m] = acc[m];
+        output[2 * m + 1] = delayed[m];
+    }
+
+    std::copy(s + numSamples, s + numSamples + history, stateData);
+}
+
+template <typename SampleType>
+void HalfBandFilter<SampleType>::downsample(int channel, const SampleType* input, SampleType* output, int numSamples) noexcept
+{
+    const int history = numTaps - 1;
+    const int oddHistory = halfOrder + 1;
+    SampleType* const evenState = downEvenHistory.data() + channel * history;
+    SampleType* const oddState = downOddHistory.data() + channel * oddHistory;
+    SampleType* const e = evenScratch.data();
+    SampleType* const o = oddScratch.data();
+
+    std::copy(evenState, evenState + history, e);
+    std::copy(oddState, oddState + oddHistory, o);
+
+    for (int m = 0; m < numSamples; ++m)
+    {
+        e[history + m] = input[2 * m];
+        o[oddHistory + m] = input[2 * m + 1];
+    }
+
+    // The odd phase only passes through the centre tap: o[m] is the input's odd sample c high-rate samples back
+    for (int m = 0; m < numSamples; ++m)
+        output[m] = SampleType(0.5) * o[m];
+
+    for (int i = 0; i < numTaps; ++i)
+    {
+        const SampleType tap = taps[static_cast<size_t>(i)];
+        const SampleType* source = e + history - i;
+
+        for (int m = 0; m < numSamples; ++m)
+            output[m] += tap * source[m];
+    }
+
+    std::copy(e + numSamples, e + numSamples + history, evenState);
+    std::copy(o + numSamples, o + numSamples + oddHistory, oddState);
+}
+
+//==============================================================================
+template <typename SampleType>
+void Oversampler<SampleType>::prepare(int newNumChannels, int maxSamplesPerBlock)
+{
+    numChannels = std::max(1, newNumChannels);
+    const int maxSamples = std::max(1, maxSamplesPerBlock);
+
+    firstStage.prepare(firstStageHalfOrder, stageAttenuationDb, numChannels, maxSamples);
+    secondStage.prepare(secondStageHalfOrder, stageAttenuationDb, numChannels, 2 * maxSamples);
+
+    // Channels padded to whole cache lines, like every other per-channel buffer
+    const size_t samplesPerLine = cacheLineSize / sizeof(SampleType);
+    const auto perChannel = (static_cast<size_t>(maxFactor * maxSamples) + samplesPerLine - 1) / samplesPerLine * samplesPerLine;
+    oversampledStorage.assign(perChannel * static_cast<size_t>(numChannels), SampleType(0));
+    intermediateStorage.assign(static_cast<size_t>(2 * maxSamples + 1), SampleType(0));
+    padding.assign(static_cast<size_t>(numChannels), SampleType(0));
+
+    oversampledChannels.resize(static_cast<size_t>(numChannels));
+    for (int channel = 0; channel < numChannels; ++channel)
+        oversampledChannels[static_cast<size_t>(channel)] = oversampledStorage.data() + static_cast<size_t>(channel) * perChannel;
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::reset() noexcept
+{
+    firstStage.reset();
+    secondStage.reset();
+    std::fill(padding.begin(), padding.end(), SampleType(0));
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::setFactor(int newFactor) noexcept
+{
+    factor = newFactor >= 4 ? 4 : (newFactor >= 2 ? 2 : 1);
+    reset();
+}
+
+template <typename SampleType>
+int Oversampler<SampleType>::getLatencySamples(int factorToQuery) noexcept
+{
+    // Round trips of 2 * halfOrder + 1 samples at each stage's low rate
+    const int firstStageLatency = 2 * firstStageHalfOrder + 1;
+    const int secondStageLatency = 2 * secondStageHalfOrder + 1;
+
+    if (factorToQuery >= 4)
+        return firstStageLatency + (secondStageLatency + 1) / 2;
+
+    return factorToQuery >= 2 ? firstStageLatency : 0;
+}
+
+template <typename SampleType>
+SampleType* const* Oversampler<SampleType>::processUp(const SampleType* const* channels, int startSample, int numSamples) noexcept
+{
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        SampleType* const out = oversampledChannels[static_cast<size_t>(channel)];
+
+        if (factor == 4)
+        {
+            firstStage.upsample(channel, channels[channel] + startSample, intermediateStorage.data(), numSamples);
+            secondStage.upsample(channel, intermediateStorage.data(), out, 2 * numSamples);
+        }
+        else
+        {
+            firstStage.upsample(channel, channels[channel] + startSample, out, numSamples);
+        }
+    }
+
+    return oversampledChannels.data();
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::processDown(SampleType* const* channels, int startSample, int numSamples) noexcept
+{
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const SampleType* const in = oversampledChannels[static_cast<size_t>(channel)];
+
+        if (factor == 4)
+        {
+            SampleType* const intermediate = intermediateStorage.data();
+            secondStage.downsample(channel, in, intermediate + 1, 2 * numSamples);
+
+            // One sample of padding at the 2x rate makes the total latency a whole number of host samples
+            intermediate[0] = padding[static_cast<size_t>(channel)];
+            padding[static_cast<size_t>(channel)] = intermediate[2 * numSamples];
+
+            firstStage.downsample(channel, intermediate, channels[channel] + startSample, numSamples);
+        }
+        else
+        {
+            firstStage.downsample(channel, in, channels[channel] + startSample, numSamples);
+        }
+    }
+}
+
+template class HalfBandFilter<float>;
+template class HalfBandFilter<double>;
+template class Oversampler<float>;
+template class Oversampler<double>;
+
+} // namespace flarksiesis
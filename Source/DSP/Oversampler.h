@@ -0,0 +1,90 @@
+#pragma once
+
+#include "AlignedVector.h"
+
+namespace flarksiesis
+{
+
+//==============================================================================
+/**
+    One 2x stage: a linear-phase half-band FIR run in polyphase form, so only
+    the non-zero taps are evaluated at the low rate.
+
+    With 4 * halfOrder + 3 taps the centre tap sits at c = 2 * halfOrder + 1.
+    All other non-zero taps have even indices, so interpolation is an FIR over
+    the input (even outputs) plus a plain delay (odd outputs), and decimation
+    is the same FIR over the even inputs plus half the delayed odd inputs. The
+    round trip delays the signal by c low-rate samples.
+
+    Taps, history and arithmetic are in SampleType, float or double.
+*/
+template <typename SampleType>
+class HalfBandFilter
+{
+public:
+    void prepare(int halfOrder, double attenuationDb, int numChannels, int maxLowRateSamples);
+    void reset() noexcept;
+
+    // Delay of an up/down round trip, in low-rate samples
+    int getRoundTripLatency() const noexcept { return 2 * halfOrder + 1; }
+
+    // 'input' holds numSamples, 'output' receives 2 * numSamples
+    void upsample(int channel, const SampleType* input, SampleType* output, int numSamples) noexcept;
+
+    // 'input' holds 2 * numSamples, 'output' receives numSamples
+    void downsample(int channel, const SampleType* input, SampleType* output, int numSamples) noexcept;
+
+private:
+    int halfOrder = 0;
+    int numTaps = 0;               // Even-index taps, 2 * halfOrder + 2
+    AlignedVector<SampleType> taps;  // h[0], h[2], ..., h[4 * halfOrder + 2]
+
+    // Per channel: numTaps - 1 samples of history in front of each block
+    AlignedVector<SampleType> upHistory, downEvenHistory, downOddHistory;
+    AlignedVector<SampleType> evenScratch, oddScratch, accumulator;
+};
+
+//==============================================================================
+/**
+    Runs a section of the signal chain at 2x or 4x the host rate.
+
+    processUp() interpolates a block into internal storage and returns one
+    pointer per channel; the caller processes factor * numSamples samples in
+    place and hands them back through processDown(). Everything is allocated
+    in prepare(), for the largest factor, so setFactor() is real-time safe.
+
+    The latency is always a whole number of host samples: at 4x the inner
+    stage's odd half-sample is padded with one extra 2x-rate sample. It is the
+    same for both sample types, and known before prepare().
+*/
+template <typename SampleType>
+class Oversampler
+{
+public:
+    static constexpr int maxFactor = 4;
+
+    void prepare(int numChannels, int maxSamplesPerBlock);
+    void reset() noexcept;
+
+    // 1, 2 or 4; clears the filter state
+    void setFactor(int newFactor) noexcept;
+    int getFactor() const noexcept { return factor; }
+
+    int getLatencySamples() const noexcept { return getLatencySamples(factor); }
+    static int getLatencySamples(int factorToQuery) noexcept;
+
+    SampleType* const* processUp(const SampleType* const* channels, int startSample, int numSamples) noexcept;
+    void processDown(SampleType* const* channels, int startSample, int numSamples) noexcept;
+
+private:
+    HalfBandFilter<SampleType> firstStage, secondStage;
+
+    int numChannels = 0;
+    int factor = 1;
+
+    AlignedVector<SampleType> oversampledStorage, intermediateStorage;
+    AlignedVector<SampleType*> oversampledChannels;
+    AlignedVector<SampleType> padding; // One 2x-rate sample per channel, used at 4x
+};
+
+} // namespace flarksiesis
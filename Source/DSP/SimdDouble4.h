@@ -0,0 +1,122 @@
+#pragma once
+
+#include "SimdFloat4.h"
+
+#if defined(__AVX__)
+ #include <immintrin.h>
+#endif
+
+namespace flarksiesis
+{
+inline namespace FLARKSIESIS_ISA
+{
+
+//==============================================================================
+// Four double lanes, the double-precision counterpart of Float4: one AVX register
+// where the kernels are built for it, two SSE2 registers on other x86, two NEON
+// registers on AArch64, plain arrays elsewhere (ARMv7 NEON has no double arithmetic)
+struct Double4
+{
+#if defined(__AVX__)
+    __m256d v;
+
+    static Double4 load(const double* p) noexcept          { return {_mm256_loadu_pd(p)}; }
+    void store(double* p) const noexcept                   { _mm256_storeu_pd(p, v); }
+    static Double4 broadcast(double x) noexcept            { return {_mm256_set1_pd(x)}; }
+
+    friend Double4 operator+(Double4 a, Double4 b) noexcept { return {_mm256_add_pd(a.v, b.v)}; }
+    friend Double4 operator-(Double4 a, Double4 b) noexcept { return {_mm256_sub_pd(a.v, b.v)}; }
+    friend Double4 operator*(Double4 a, Double4 b) noexcept { return {_mm256_mul_pd(a.v, b.v)}; }
+    friend Double4 operator/(Double4 a, Double4 b) noexcept { return {_mm256_div_pd(a.v, b.v)}; }
+#elif FLARKSIESIS_SIMD_SSE2
+    __m128d lo, hi;
+
+    static Double4 load(const double* p) noexcept          { return {_mm_loadu_pd(p), _mm_loadu_pd(p + 2)}; }
+    void store(double* p) const noexcept                   { _mm_storeu_pd(p, lo); _mm_storeu_pd(p + 2, hi); }
+    static Double4 broadcast(double x) noexcept            { return {_mm_set1_pd(x), _mm_set1_pd(x)}; }
+
+    friend Double4 operator+(Double4 a, Double4 b) noexcept { return {_mm_add_pd(a.lo, b.lo), _mm_add_pd(a.hi, b.hi)}; }
+    friend Double4 operator-(Double4 a, Double4 b) noexcept { return {_mm_sub_pd(a.lo, b.lo), _mm_sub_pd(a.hi, b.hi)}; }
+    friend Double4 operator*(Double4 a, Double4 b) noexcept { return {_mm_mul_pd(a.lo, b.lo), _mm_mul_pd(a.hi, b.hi)}; }
+    friend Double4 operator/(Double4 a, Double4 b) noexcept { return {_mm_div_pd(a.lo, b.lo), _mm_div_pd(a.hi, b.hi)}; }
+#elif FLARKSIESIS_SIMD_NEON && (defined(__aarch64__) || defined(_M_ARM64))
+    float64x2_t lo, hi;
+
+    static Double4 load(const double* p) noexcept          { return {vld1q_f64(p), vld1q_f64(p + 2)}; }
+    void store(double* p) const noexcept                   { vst1q_f64(p, lo); vst1q_f64(p + 2, hi); }
+    static Double4 broadcast(double x) noexcept            { return {vdupq_n_f64(x), vdupq_n_f64(x)}; }
+
+    friend Double4 operator+(Double4 a, Double4 b) noexcept { return {vaddq_f64(a.lo, b.lo), vaddq_f64(a.hi, b.hi)}; }
+    friend Double4 operator-(Double4 a, Double4 b) noexcept { return {vsubq_f64(a.lo, b.lo), vsubq_f64(a.hi, b.hi)}; }
+    friend Double4 operator*(Double4 a, Double4 b) noexcept { return {vmulq_f64(a.lo, b.lo), vmulq_f64(a.hi, b.hi)}; }
+    friend Double4 operator/(Double4 a, Double4 b) noexcept { return {vdivq_f64(a.lo, b.lo), vdivq_f64(a.hi, b.hi)}; }
+#else
+ #define FLARKSIESIS_SIMD_DOUBLE_SCALAR 1
+    double v[4];
+
+    static Double4 load(const double* p) noexcept          { return {{p[0], p[1], p[2], p[3]}}; }
+    void store(double* p) const noexcept                   { for (int i = 0; i < 4; ++i) p[i] = v[i]; }
+    static Double4 broadcast(double x) noexcept            { return {{x, x, x, x}}; }
+
+    friend Double4 operator+(Double4 a, Double4 b) noexcept { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+    friend Double4 operator-(Double4 a, Double4 b) noexcept { for (int i = 0; i < 4; ++i) a.v[i] -= b.v[i]; return a; }
+    friend Double4 operator*(Double4 a, Double4 b) noexcept { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+    friend Double4 operator/(Double4 a, Double4 b) noexcept { for (int i = 0; i < 4; ++i) a.v[i] /= b.v[i]; return a; }
+#endif
+
+    Double4& operator+=(Double4 other) noexcept { return *this = *this + other; }
+};
+
+// Turns four rows of four samples into four columns
+inline void transpose(Double4& r0, Double4& r1, Double4& r2, Double4& r3) noexcept
+{
+#if defined(__AVX__)
+    const __m256d t0 = _mm256_unpacklo_pd(r0.v, r1.v), t1 = _mm256_unpackhi_pd(r0.v, r1.v);
+    const __m256d t2 = _mm256_unpacklo_pd(r2.v, r3.v), t3 = _mm256_unpackhi_pd(r2.v, r3.v);
+    r0.v = _mm256_permute2f128_pd(t0, t2, 0x20);
+    r1.v = _mm256_permute2f128_pd(t1, t3, 0x20);
+    r2.v = _mm256_permute2f128_pd(t0, t2, 0x31);
+    r3.v = _mm256_permute2f128_pd(t1, t3, 0x31);
+#elif FLARKSIESIS_SIMD_DOUBLE_SCALAR
+    Double4* rows[4] = {&r0, &r1, &r2, &r3};
+    for (int i = 0; i < 4; ++i)
+        for (int j = i + 1; j < 4; ++j)
+        {
+            const double t = rows[i]->v[j];
+            rows[i]->v[j] = rows[j]->v[i];
+            rows[j]->v[i] = t;
+        }
+#else
+    // Each row is two pairs; swap the off-diagonal 2x2 blocks, then transpose each block
+    auto transpose2 = [](auto& a, auto& b)
+    {
+ #if FLARKSIESIS_SIMD_SSE2
+        const __m128d low = _mm_unpacklo_pd(a, b), high = _mm_unpackhi_pd(a, b);
+ #else
+        const float64x2_t low = vzip1q_f64(a, b), high = vzip2q_f64(a, b);
+ #endif
+        a = low;
+        b = high;
+    };
+
+    transpose2(r0.lo, r1.lo);
+    transpose2(r2.hi, r3.hi);
+    transpose2(r0.hi, r1.hi);
+    transpose2(r2.lo, r3.lo);
+
+    const auto r0High = r0.hi, r1High = r1.hi;
+    r0.hi = r2.lo;
+    r2.lo = r0High;
+    r1.hi = r3.lo;
+    r3.lo = r1High;
+#endif
+}
+
+//==============================================================================
+// The four-lane vector for a sample type, so the filter kernels can be written once
+template <typename SampleType> struct SimdVector;
+template <> struct SimdVector<float>  { using Type = Float4; };
+template <> struct SimdVector<double> { using Type = Double4; };
+
+} // namespace FLARKSIESIS_ISA
+} // namespace flarksiesis
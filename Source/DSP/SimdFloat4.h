@@ -0,0 +1,168 @@
+#pragma once
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #define FLARKSIESIS_SIMD_SSE2 1
+ #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+ #define FLARKSIESIS_SIMD_NEON 1
+ #include <arm_neon.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// Kernels built for an instruction set above the target's baseline (see Kernels.h) define
+// FLARKSIESIS_ISA before including this. Everything in this header then lives in a namespace
+// of that name, so the linker can't keep an inline function compiled for another CPU in place
+// of this one. For the same reason nothing here calls inline functions from elsewhere, such as
+// std::min: those would be compiled with the kernels' instruction set too.
+#ifndef FLARKSIESIS_ISA
+ #define FLARKSIESIS_ISA baseline
+#endif
+
+namespace flarksiesis
+{
+inline namespace FLARKSIESIS_ISA
+{
+
+//==============================================================================
+// Four float lanes: SSE2 on x86, NEON on ARM, plain arrays elsewhere
+struct Float4
+{
+#if FLARKSIESIS_SIMD_SSE2
+    __m128 v;
+
+    static Float4 load(const float* p) noexcept            { return {_mm_loadu_ps(p)}; }
+    void store(float* p) const noexcept                    { _mm_storeu_ps(p, v); }
+    static Float4 broadcast(float x) noexcept              { return {_mm_set1_ps(x)}; }
+
+    friend Float4 operator+(Float4 a, Float4 b) noexcept   { return {_mm_add_ps(a.v, b.v)}; }
+    friend Float4 operator-(Float4 a, Float4 b) noexcept   { return {_mm_sub_ps(a.v, b.v)}; }
+    friend Float4 operator*(Float4 a, Float4 b) noexcept   { return {_mm_mul_ps(a.v, b.v)}; }
+    friend Float4 operator/(Float4 a, Float4 b) noexcept   { return {_mm_div_ps(a.v, b.v)}; }
+    friend Float4 min(Float4 a, Float4 b) noexcept         { return {_mm_min_ps(a.v, b.v)}; }
+    friend Float4 max(Float4 a, Float4 b) noexcept         { return {_mm_max_ps(a.v, b.v)}; }
+#elif FLARKSIESIS_SIMD_NEON
+    float32x4_t v;
+
+    static Float4 load(const float* p) noexcept            { return {vld1q_f32(p)}; }
+    void store(float* p) const noexcept                    { vst1q_f32(p, v); }
+    static Float4 broadcast(float x) noexcept              { return {vdupq_n_f32(x)}; }
+
+    friend Float4 operator+(Float4 a, Float4 b) noexcept   { return {vaddq_f32(a.v, b.v)}; }
+    friend Float4 operator-(Float4 a, Float4 b) noexcept   { return {vsubq_f32(a.v, b.v)}; }
+    friend Float4 operator*(Float4 a, Float4 b) noexcept   { return {vmulq_f32(a.v, b.v)}; }
+ #if defined(__aarch64__) || defined(_M_ARM64)
+    friend Float4 operator/(Float4 a, Float4 b) noexcept   { return {vdivq_f32(a.v, b.v)}; }
+ #else
+    // ARMv7 NEON has no divide: a reciprocal estimate refined by two Newton-Raphson steps
+    friend Float4 operator/(Float4 a, Float4 b) noexcept
+    {
+        float32x4_t r = vrecpeq_f32(b.v);
+        r = vmulq_f32(r, vrecpsq_f32(b.v, r));
+        r = vmulq_f32(r, vrecpsq_f32(b.v, r));
+        return {vmulq_f32(a.v, r)};
+    }
+ #endif
+    friend Float4 min(Float4 a, Float4 b) noexcept         { return {vminq_f32(a.v, b.v)}; }
+    friend Float4 max(Float4 a, Float4 b) noexcept         { return {vmaxq_f32(a.v, b.v)}; }
+#else
+    float v[4];
+
+    static Float4 load(const float* p) noexcept            { return {{p[0], p[1], p[2], p[3]}}; }
+    void store(float* p) const noexcept                    { for (int i = 0; i < 4; ++i) p[i] = v[i]; }
+    static Float4 broadcast(float x) noexcept              { return {{x, x, x, x}}; }
+
+    friend Float4 operator+(Float4 a, Float4 b) noexcept   { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+    friend Float4 operator-(Float4 a, Float4 b) noexcept   { for (int i = 0; i < 4; ++i) a.v[i] -= b.v[i]; return a; }
+    friend Float4 operator*(Float4 a, Float4 b) noexcept   { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+    friend Float4 operator/(Float4 a, Float4 b) noexcept   { for (int i = 0; i < 4; ++i) a.v[i] /= b.v[i]; return a; }
+    friend Float4 min(Float4 a, Float4 b) noexcept         { for (int i = 0; i < 4; ++i) a.v[i] = b.v[i] < a.v[i] ? b.v[i] : a.v[i]; return a; }
+    friend Float4 max(Float4 a, Float4 b) noexcept         { for (int i = 0; i < 4; ++i) a.v[i] = a.v[i] < b.v[i] ? b.v[i] : a.v[i]; return a; }
+#endif
+
+    Float4& operator+=(Float4 other) noexcept { return *this = *this + other; }
+};
+
+// Turns four rows of four samples into four columns
+inline void transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3) noexcept
+{
+#if FLARKSIESIS_SIMD_SSE2
+    _MM_TRANSPOSE4_PS(r0.v, r1.v, r2.v, r3.v);
+#elif FLARKSIESIS_SIMD_NEON
+    const float32x4x2_t t01 = vtrnq_f32(r0.v, r1.v);
+    const float32x4x2_t t23 = vtrnq_f32(r2.v, r3.v);
+    r0.v = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    r1.v = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    r2.v = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    r3.v = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+#else
+    Float4* rows[4] = {&r0, &r1, &r2, &r3};
+    for (int i = 0; i < 4; ++i)
+        for (int j = i + 1; j < 4; ++j)
+        {
+            const float t = rows[i]->v[j];
+            rows[i]->v[j] = rows[j]->v[i];
+            rows[j]->v[i] = t;
+        }
+#endif
+}
+
+//==============================================================================
+// 2^x as 2^floor(x) from the exponent bits times a degree-5 minimax polynomial
+// for the fraction: within 2e-7 relative (0.00035 cents) for x in [-126, 126].
+// Tests/FastExp2 checks that bound.
+namespace exp2Detail
+{
+    constexpr float c1 = 0.693151312f, c2 = 0.240164449f, c3 = 0.0557999156f,
+                    c4 = 0.00901702781f, c5 = 0.00186713096f;
+}
+
+inline float fastExp2(float x) noexcept
+{
+    using namespace exp2Detail;
+    x = -126.0f < x ? x : -126.0f;
+    x = x < 126.0f ? x : 126.0f;
+
+    auto whole = static_cast<std::int32_t>(x);
+    whole -= static_cast<float>(whole) > x ? 1 : 0;
+    const float f = x - static_cast<float>(whole);
+
+    const auto bits = static_cast<std::uint32_t>(whole + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+
+    return scale * (1.0f + f * (c1 + f * (c2 + f * (c3 + f * (c4 + f * c5)))));
+}
+
+inline Float4 fastExp2(Float4 x) noexcept
+{
+    using namespace exp2Detail;
+    x = min(Float4::broadcast(126.0f), max(Float4::broadcast(-126.0f), x));
+
+#if FLARKSIESIS_SIMD_SSE2 || FLARKSIESIS_SIMD_NEON
+ #if FLARKSIESIS_SIMD_SSE2
+    __m128i whole = _mm_cvttps_epi32(x.v);
+    whole = _mm_add_epi32(whole, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(whole), x.v))); // -1 where truncation rounded up
+    const Float4 f = x - Float4 {_mm_cvtepi32_ps(whole)};
+    const Float4 scale {_mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(whole, _mm_set1_epi32(127)), 23))};
+ #else
+    int32x4_t whole = vcvtq_s32_f32(x.v);
+    whole = vaddq_s32(whole, vreinterpretq_s32_u32(vcgtq_f32(vcvtq_f32_s32(whole), x.v))); // -1 where truncation rounded up
+    const Float4 f = x - Float4 {vcvtq_f32_s32(whole)};
+    const Float4 scale {vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(whole, vdupq_n_s32(127)), 23))};
+ #endif
+
+    const Float4 poly = Float4::broadcast(1.0f) + f * (Float4::broadcast(c1) + f * (Float4::broadcast(c2) + f * (Float4::broadcast(c3)
+                                                + f * (Float4::broadcast(c4) + f * Float4::broadcast(c5)))));
+    return scale * poly;
+#else
+    for (int i = 0; i < 4; ++i)
+        x.v[i] = fastExp2(x.v[i]);
+    return x;
+#endif
+}
+
+} // namespace FLARKSIESIS_ISA
+} // namespace flarksiesis
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace flarksiesis
+{
+
+enum SmoothingType { linearSmoothing, multiplicativeSmoothing };
+
+//==============================================================================
+/**
+    Per-sample parameter ramp: setTargetValue() starts a ramp of a fixed number
+    of steps from the current value, either linear or multiplicative (linear in
+    the log domain, so it never crosses zero).
+
+    The arithmetic is juce::SmoothedValue's, step for step, so the DSP core
+    renders exactly what the plugin did when it used those.
+*/
+template <SmoothingType Type>
+class Smoother
+{
+public:
+    // Ramps take floor (rampLengthSeconds * sampleRate) steps; jumps to the target
+    void reset(double sampleRate, double rampLengthSeconds) noexcept
+    {
+        stepsToTarget = static_cast<int>(std::floor(rampLengthSeconds * sampleRate));
+        setCurrentAndTargetValue(target);
+    }
+
+    void setCurrentAndTargetValue(float newValue) noexcept
+    {
+        target = currentValue = newValue;
+        countdown = 0;
+    }
+
+    // Targets within rounding of the current one are ignored, so the ramp carries on
+    void setTargetValue(float newValue) noexcept
+    {
+        if (isCloseTo(newValue, target))
+            return;
+
+        if (stepsToTarget <= 0)
+        {
+            setCurrentAndTargetValue(newValue);
+            return;
+        }
+
+        target = newValue;
+        countdown = stepsToTarget;
+
+        if constexpr (Type == linearSmoothing)
+            step = (target - currentValue) / static_cast<float>(countdown);
+        else
+            step = std::exp((std::log(std::abs(target)) - std::log(std::abs(currentValue))) / static_cast<float>(countdown));
+    }
+
+    float getNextValue() noexcept
+    {
+        if (! isSmoothing())
+            return target;
+
+        --countdown;
+
+        if (! isSmoothing())
+            currentValue = target;
+        else if constexpr (Type == linearSmoothing)
+            currentValue += step;
+        else
+            currentValue *= step;
+
+        return currentValue;
+    }
+
+    // Moves on by numSamples, as that many calls to getNextValue() would (up to rounding)
+    void skip(int numSamples) noexcept
+    {
+        if (numSamples >= countdown)
+        {
+            setCurrentAndTargetValue(target);
+            return;
+        }
+
+        if constexpr (Type == linearSmoothing)
+            currentValue += step * static_cast<float>(numSamples);
+        else
+            currentValue *= static_cast<float>(std::pow(step, numSamples));
+
+        countdown -= numSamples;
+    }
+
+    float getCurrentValue() const noexcept { return currentValue; }
+    bool isSmoothing() const noexcept { return countdown > 0; }
+
+private:
+    static bool isCloseTo(float a, float b) noexcept
+    {
+        if (! (std::isfinite(a) && std::isfinite(b)))
+            return a == b;
+
+        const float difference = std::abs(a - b);
+        return difference <= std::numeric_limits<float>::min()
+            || difference <= std::numeric_limits<float>::epsilon() * std::max(std::abs(a), std::abs(b));
+    }
+
+    float currentValue = Type == linearSmoothing ? 0.0f : 1.0f;
+    float target = currentValue;
+    float step = 0.0f;
+    int countdown = 0;
+    int stepsToTarget = 0;
+};
+
+} // namespace flarksiesis
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace flarksiesis
+{
+
+//==============================================================================
+/**
+    Wait-free single-producer, single-consumer queue of trivially copyable values.
+
+    One thread may push and one other thread may pop; neither ever blocks. When
+    the queue is full, push() drops the new value and returns false, so a slow
+    or absent reader can't hold up the audio thread. Capacity must be a power
+    of two; one slot is kept free to tell full from empty.
+*/
+template <typename Type, size_t Capacity>
+class SpscQueue
+{
+public:
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    bool push(const Type& value) noexcept
+    {
+        const size_t write = writeIndex.load(std::memory_order_relaxed);
+        const size_t next = (write + 1) & (Capacity - 1);
+
+        if (next == readIndex.load(std::memory_order_acquire))
+            return false;
+
+        slots[write] = value;
+        writeIndex.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(Type& value) noexcept
+    {
+        const size_t read = readIndex.load(std::memory_order_relaxed);
+
+        if (read == writeIndex.load(std::memory_order_acquire))
+            return false;
+
+        value = slots[read];
+        readIndex.store((read + 1) & (Capacity - 1), std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer only: drops everything queued so far. */
+    void clear() noexcept
+    {
+        readIndex.store(writeIndex.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    // The indices live on separate cache lines so the two threads don't keep stealing each other's line
+    alignas(64) std::atomic<size_t> writeIndex {0};
+    alignas(64) std::atomic<size_t> readIndex {0};
+    alignas(64) std::array<Type, Capacity> slots {};
+};
+
+} // namespace flarksiesis
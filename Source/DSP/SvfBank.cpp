@@ -0,0 +1,212 @@
+#include "SvfBank.h"
+
+#include <algorithm>
+
+namespace flarksiesis
+{
+
+template <typename SampleType>
+void SvfBank<SampleType>::prepare(int newNumChannels, int maxSamplesPerCall)
+{
+    numChannels = std::max(0, newNumChannels);
+    groups.resize(static_cast<size_t>((numChannels + lanes - 1) / lanes));
+    unusedLane.assign(static_cast<size_t>(std::max(maxSamplesPerCall, lanes)), SampleType(0));
+    reset();
+}
+
+template <typename SampleType>
+void SvfBank<SampleType>::reset() noexcept
+{
+    const SvfCoefficients bypass;
+
+    for (auto& group : groups)
+    {
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            group.ic1[lane] = group.ic2[lane] = SampleType(0);
+            group.g[lane] = group.tg[lane] = bypass.g;
+            group.k[lane] = group.tk[lane] = bypass.k;
+            group.m0[lane] = group.tm0[lane] = bypass.m0;
+            group.m1[lane] = group.tm1[lane] = bypass.m1;
+            group.m2[lane] = group.tm2[lane] = bypass.m2;
+            group.hasCoefficients[lane] = false;
+        }
+    }
+
+    std::fill(unusedLane.begin(), unusedLane.end(), SampleType(0));
+    kernel = kernels->svf[genericResponse];
+    rampRemaining = 0;
+}
+
+template <typename SampleType>
+void SvfBank<SampleType>::setTarget(int channel, const SvfCoefficients& target) noexcept
+{
+    auto& group = groups[static_cast<size_t>(channel / lanes)];
+    const int lane = channel % lanes;
+
+    group.tg[lane] = target.g;
+    group.tk[lane] = target.k;
+    group.tm0[lane] = target.m0;
+    group.tm1[lane] = target.m1;
+    group.tm2[lane] = target.m2;
+
+    if (! group.hasCoefficients[lane])
+    {
+        group.g[lane] = target.g;
+        group.k[lane] = target.k;
+        group.m0[lane] = target.m0;
+        group.m1[lane] = target.m1;
+        group.m2[lane] = target.m2;
+        group.hasCoefficients[lane] = true;
+    }
+}
+
+template <typename SampleType>
+void SvfBank<SampleType>::setFilterType(int filterType) noexcept
+{
+    const auto newResponse = getFilterResponse(filterType);
+
+    if (newResponse != response)
+    {
+        response = newResponse;
+        kernel = kernels->svf[genericResponse];
+    }
+}
+
+template <typename SampleType>
+void SvfBank<SampleType>::resolveLanes(int groupIndex, SampleType* const* channels, int startSample,
+                                       SampleType* (&lanePointers)[lanes]) noexcept
+{
+    for (int lane = 0; lane < lanes; ++lane)
+    {
+        const int channel = groupIndex * lanes + lane;
+        lanePointers[lane] = channel < numChannels ? channels[channel] + startSample
+                                                   : unusedLane.data();
+    }
+}
+
+template <typename SampleType>
+void SvfBank<SampleType>::startRamp(int rampSamples) noexcept
+{
+    rampRemaining = std::max(1, rampSamples);
+    const SampleType step = SampleType(1) / static_cast<SampleType>(rampRemaining);
+
+    for (auto& group : groups)
+    {
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            group.dg[lane] = (group.tg[lane] - group.g[lane]) * step;
+            group.dk[lane] = (group.tk[lane] - group.k[lane]) * step;
+            group.dm0[lane] = (group.tm0[lane] - group.m0[lane]) * step;
+            group.dm1[lane] = (group.tm1[lane] - group.m1[lane]) * step;
+            group.dm2[lane] = (group.tm2[lane] - group.m2[lane]) * step;
+        }
+    }
+}
+
+template <typename SampleType>
+void SvfBank<SampleType>::landOnTargets() noexcept
+{
+    for (auto& group : groups)
+    {
+        std::copy(group.tg, group.tg + lanes, group.g);
+        std::copy(group.tk, group.tk + lanes, group.k);
+        std::copy(group.tm0, group.tm0 + lanes, group.m0);
+        std::copy(group.tm1, group.tm1 + lanes, group.m1);
+        std::copy(group.tm2, group.tm2 + lanes, group.m2);
+    }
+
+    kernel = kernels->svf[response];
+}
+
+template <typename SampleType>
+void SvfBank<SampleType>::process(SampleType* const* channels, int startSample, int numSamples) noexcept
+{
+    for (int done = 0; done < numSamples;)
+    {
+        // Past the end of a ramp, the next runs on the targets
+        if (rampRemaining <= 0)
+            startRamp(numSamples - done);
+
+        const int length = std::min(numSamples - done, rampRemaining);
+
+        for (size_t gi = 0; gi < groups.size(); ++gi)
+        {
+            SampleType* lane[lanes];
+            resolveLanes(static_cast<int>(gi), channels, startSample + done, lane);
+            kernel(groups[gi], lane, length);
+        }
+
+        done += length;
+
+        if ((rampRemaining -= length) == 0)
+            landOnTargets();
+    }
+}
+
+template <typename SampleType>
+void SvfBank<SampleType>::processReference(SampleType* const* channels, int startSample, int numSamples) noexcept
+{
+    using T = SampleType;
+
+    for (int done = 0; done < numSamples;)
+    {
+        if (rampRemaining <= 0)
+            startRamp(numSamples - done);
+
+        const int length = std::min(numSamples - done, rampRemaining);
+
+        for (size_t gi = 0; gi < groups.size(); ++gi)
+        {
+            auto& group = groups[gi];
+
+            for (int l = 0; l < lanes; ++l)
+            {
+                const int channel = static_cast<int>(gi) * lanes + l;
+
+                if (channel >= numChannels)
+                    break;
+
+                T g = group.g[l], k = group.k[l];
+                T m0 = group.m0[l], m1 = group.m1[l], m2 = group.m2[l];
+                T ic1 = group.ic1[l], ic2 = group.ic2[l];
+
+                T* samples = channels[channel] + startSample + done;
+
+                for (int i = 0; i < length; ++i)
+                {
+                    g += group.dg[l]; k += group.dk[l];
+                    m0 += group.dm0[l]; m1 += group.dm1[l]; m2 += group.dm2[l];
+
+                    const T a1 = T(1) / (T(1) + g * (g + k));
+                    const T a2 = g * a1;
+                    const T a3 = g * a2;
+
+                    const T input = samples[i];
+                    const T v3 = input - ic2;
+                    const T v1 = a1 * ic1 + a2 * v3;
+                    const T v2 = ic2 + a2 * ic1 + a3 * v3;
+
+                    ic1 = T(2) * v1 - ic1;
+                    ic2 = T(2) * v2 - ic2;
+
+                    samples[i] = m0 * input + m1 * v1 + m2 * v2;
+                }
+
+                group.ic1[l] = ic1; group.ic2[l] = ic2;
+                group.g[l] = g; group.k[l] = k;
+                group.m0[l] = m0; group.m1[l] = m1; group.m2[l] = m2;
+            }
+        }
+
+        done += length;
+
+        if ((rampRemaining -= length) == 0)
+            landOnTargets();
+    }
+}
+
+template class SvfBank<float>;
+template class SvfBank<double>;
+
+} // namespace flarksiesis
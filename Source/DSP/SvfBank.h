@@ -0,0 +1,77 @@
+#pragma once
+
+#include "AlignedVector.h"
+#include "FilterCoefficients.h"
+#include "Kernels.h"
+
+namespace flarksiesis
+{
+
+//==============================================================================
+/**
+    Zero-delay-feedback (topology-preserving transform) state-variable filters
+    for several channels, stored channel-interleaved like BiquadBank, four
+    channels per SIMD register.
+
+    The state is two integrators, and unlike a biquad's their meaning doesn't
+    depend on the coefficients, so g and k can change on every sample without
+    the filter blowing up or clicking: process() ramps g, k and the output mix
+    linearly from the current values to the targets across each ramp (split
+    across calls as BiquadBank's are), and
+    solves the zero-delay loop per sample (one divide per four channels). The
+    output mix selects the response, so all eight filter types come from the
+    same state, and a type change just moves the mix.
+
+    As in BiquadBank, the loop is a kernel built once per FilterResponse and
+    instruction set (see Kernels.h), and setFilterType() picks one per block.
+    A shaped kernel ramps g and k only and reads its output straight off the
+    state (the lowpass is v2): with the mix fixed by the response, it is
+    exactly what the generic kernel computes.
+
+    SampleType is float or double, as in BiquadBank; the SVF designs are float.
+    processReference() is the scalar form of the same arithmetic.
+*/
+template <typename SampleType>
+class SvfBank
+{
+public:
+    static constexpr int lanes = 4;
+
+    // Allocates state for numChannels; maxSamplesPerCall bounds numSamples in process()
+    void prepare(int numChannels, int maxSamplesPerCall);
+    void reset() noexcept;
+
+    int getNumChannels() const noexcept { return numChannels; }
+
+    // Coefficients this channel should reach at the end of the next ramp.
+    // The first target after reset() is applied immediately instead of ramped.
+    void setTarget(int channel, const SvfCoefficients& target) noexcept;
+
+    // As BiquadBank::startRamp()
+    void startRamp(int rampSamples) noexcept;
+
+    // Picks the kernel, as BiquadBank::setFilterType() does
+    void setFilterType(int filterType) noexcept;
+
+    void process(SampleType* const* channels, int startSample, int numSamples) noexcept;
+    void processReference(SampleType* const* channels, int startSample, int numSamples) noexcept;
+
+private:
+    using Group = SvfLanes<SampleType>;
+    using Kernel = typename SampleKernels<SampleType>::SvfKernel;
+
+    AlignedVector<Group> groups;
+    AlignedVector<SampleType> unusedLane; // Input/output for lanes past the last channel
+    int numChannels = 0;
+
+    const SampleKernels<SampleType>* kernels = &getKernels().forSampleType<SampleType>();
+    FilterResponse response = genericResponse;       // Of the targets
+    Kernel kernel = kernels->svf[genericResponse];    // For the current coefficients
+    int rampRemaining = 0;                            // Samples left in the ramp to the targets
+
+    void resolveLanes(int groupIndex, SampleType* const* channels, int startSample,
+                      SampleType* (&lanePointers)[lanes]) noexcept;
+    void landOnTargets() noexcept;
+};
+
+} // namespace flarksiesis
@@ -0,0 +1,93 @@
+#include "LoadMeter.h"
+
+#include <algorithm>
+
+namespace flarksiesis
+{
+
+void LoadMeter::prepare(double newSampleRate) noexcept
+{
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+    reset();
+}
+
+void LoadMeter::clear() noexcept
+{
+    numBlocks.store(0, std::memory_order_relaxed);
+    numOverBudget.store(0, std::memory_order_relaxed);
+    loadSum.store(0.0, std::memory_order_relaxed);
+    maxLoad.store(0.0, std::memory_order_relaxed);
+    lastLoad.store(0.0, std::memory_order_relaxed);
+
+    for (auto& bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+void LoadMeter::addBlock(double seconds, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    if (resetRequested.load(std::memory_order_relaxed))
+    {
+        resetRequested.store(false, std::memory_order_relaxed);
+        clear();
+    }
+
+    const double load = seconds * sampleRate / numSamples;
+    const int bucket = std::min(numBuckets - 1, static_cast<int>(load / bucketWidth));
+
+    auto& counter = buckets[static_cast<size_t>(bucket)];
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    loadSum.store(loadSum.load(std::memory_order_relaxed) + load, std::memory_order_relaxed);
+    lastLoad.store(load, std::memory_order_relaxed);
+
+    if (load > maxLoad.load(std::memory_order_relaxed))
+        maxLoad.store(load, std::memory_order_relaxed);
+
+    if (load > 1.0)
+        numOverBudget.store(numOverBudget.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    // Published last, so a reader that sees this count sees at least as many blocks in the other fields
+    numBlocks.store(numBlocks.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+LoadMeter::Statistics LoadMeter::getStatistics() const noexcept
+{
+    Statistics statistics;
+    statistics.numBlocks = numBlocks.load(std::memory_order_acquire);
+
+    if (statistics.numBlocks == 0)
+        return statistics;
+
+    statistics.numOverBudget = numOverBudget.load(std::memory_order_relaxed);
+    statistics.meanLoad = loadSum.load(std::memory_order_relaxed) / static_cast<double>(statistics.numBlocks);
+    statistics.maxLoad = maxLoad.load(std::memory_order_relaxed);
+    statistics.lastLoad = lastLoad.load(std::memory_order_relaxed);
+
+    // The counters keep moving while they're read, so total them rather than trusting numBlocks
+    std::array<std::uint32_t, numBuckets> counts;
+    std::uint64_t total = 0;
+
+    for (int i = 0; i < numBuckets; ++i)
+        total += counts[static_cast<size_t>(i)] = buckets[static_cast<size_t>(i)].load(std::memory_order_relaxed);
+
+    const auto threshold = static_cast<std::uint64_t>(static_cast<double>(total) * 0.99);
+    std::uint64_t seen = 0;
+
+    for (int i = 0; i < numBuckets; ++i)
+    {
+        seen += counts[static_cast<size_t>(i)];
+
+        if (seen > threshold)
+        {
+            statistics.p99Load = (i + 1) * bucketWidth;
+            break;
+        }
+    }
+
+    return statistics;
+}
+
+} // namespace flarksiesis
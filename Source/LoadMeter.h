@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace flarksiesis
+{
+
+//==============================================================================
+/**
+    Measures how much of the buffer period each audio callback uses.
+
+    The audio thread wraps processBlock in a ScopedMeasurement. Each block's
+    load (time taken over the time the block represents) goes into a histogram
+    of lock-free counters, along with the mean, the maximum and the number of
+    over-budget blocks. Any thread can read the statistics.
+
+    Measuring is off until something holds a ScopedReader, such as the editor
+    or a command line tool, so an instance nobody is watching only pays for one
+    relaxed atomic load per block. The statistics cover the time since the
+    first reader arrived, or since the last reset().
+*/
+class LoadMeter
+{
+public:
+    // Histogram buckets are 2% of the budget wide; the last one collects everything from 250% up
+    static constexpr int numBuckets = 126;
+    static constexpr double bucketWidth = 0.02;
+
+    struct Statistics
+    {
+        std::uint64_t numBlocks = 0;
+        std::uint64_t numOverBudget = 0;  // Blocks that took longer than their buffer period
+        double meanLoad = 0.0;            // 1.0 is the whole buffer period
+        double p99Load = 0.0;             // Resolution is one bucket
+        double maxLoad = 0.0;
+        double lastLoad = 0.0;
+    };
+
+    //==============================================================================
+    /** Call before processing starts; not thread safe against the audio thread. */
+    void prepare(double sampleRate) noexcept;
+
+    /** Asks the audio thread to clear the statistics at its next block. */
+    void reset() noexcept { resetRequested.store(true, std::memory_order_relaxed); }
+
+    Statistics getStatistics() const noexcept;
+
+    //==============================================================================
+    /** Turns measuring on for as long as it exists. */
+    class ScopedReader
+    {
+    public:
+        explicit ScopedReader(LoadMeter& meterToRead) noexcept : meter(meterToRead) { meter.numReaders.fetch_add(1); }
+        ~ScopedReader() { meter.numReaders.fetch_sub(1); }
+
+        ScopedReader(const ScopedReader&) = delete;
+        ScopedReader& operator=(const ScopedReader&) = delete;
+
+    private:
+        LoadMeter& meter;
+    };
+
+    /** Times one audio callback of numSamples samples. */
+    class ScopedMeasurement
+    {
+    public:
+        ScopedMeasurement(LoadMeter& meterToUse, int numSamplesInBlock) noexcept
+            : meter(meterToUse.numReaders.load(std::memory_order_relaxed) > 0 ? &meterToUse : nullptr),
+              numSamples(numSamplesInBlock)
+        {
+            if (meter != nullptr)
+                start = Clock::now();
+        }
+
+        ~ScopedMeasurement()
+        {
+            if (meter != nullptr)
+                meter->addBlock(std::chrono::duration<double>(Clock::now() - start).count(), numSamples);
+        }
+
+        ScopedMeasurement(const ScopedMeasurement&) = delete;
+        ScopedMeasurement& operator=(const ScopedMeasurement&) = delete;
+
+    private:
+        LoadMeter* const meter;
+        const int numSamples;
+        std::chrono::steady_clock::time_point start;
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Audio thread only; a single writer, so plain loads and stores are enough for the counters
+    void addBlock(double seconds, int numSamples) noexcept;
+    void clear() noexcept;
+
+    double sampleRate = 44100.0;
+
+    std::atomic<int> numReaders {0};
+    std::atomic<bool> resetRequested {false};
+
+    std::atomic<std::uint64_t> numBlocks {0}, numOverBudget {0};
+    std::atomic<double> loadSum {0.0}, maxLoad {0.0}, lastLoad {0.0};
+    std::array<std::atomic<std::uint32_t>, numBuckets> buckets {};
+};
+
+} // namespace flarksiesis
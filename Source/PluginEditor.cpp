@@ -3,7 +3,7 @@
 
 //==============================================================================
 FlarksiesisAudioProcessorEditor::FlarksiesisAudioProcessorEditor(FlarksiesisAudioProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p), lfoVisualizer(p)
+    : AudioProcessorEditor(&p), audioProcessor(p), lfoVisualizer(p), loadMeterDisplay(p)
 {
     // Set colors
     getLookAndFeel().setColour(juce::Slider::thumbColourId, juce::Colour(0xFFFF6600));
@@ -59,6 +59,16 @@ FlarksiesisAudioProcessorEditor::FlarksiesisAudioProcessorEditor(FlarksiesisAudi
     filterTypeBox.addItem("HP 12dB", 7);
     filterTypeBox.addItem("BP 12dB", 8);
 
+    addAndMakeVisible(filterEngineBox);
+    filterEngineBox.addItem("Biquad", 1);
+    filterEngineBox.addItem("SVF", 2);
+
+    setupLabel(oversamplingLabel, "Oversampling");
+    addAndMakeVisible(oversamplingBox);
+    oversamplingBox.addItem("Off", 1);
+    oversamplingBox.addItem("2x", 2);
+    oversamplingBox.addItem("4x", 3);
+
     // Mix Section
     setupLabel(mixLabel, "Mix");
     setupLabel(stereoWidthLabel, "Width");
@@ -71,6 +81,9 @@ FlarksiesisAudioProcessorEditor::FlarksiesisAudioProcessorEditor(FlarksiesisAudi
     // LFO Visualizer
     addAndMakeVisible(lfoVisualizer);
 
+    // DSP load
+    addAndMakeVisible(loadMeterDisplay);
+
     // Create attachments
     rateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
         audioProcessor.getAPVTS(), "rate", rateSlider);
@@ -90,9 +103,14 @@ FlarksiesisAudioProcessorEditor::FlarksiesisAudioProcessorEditor(FlarksiesisAudi
         audioProcessor.getAPVTS(), "waveform", waveformBox);
     filterTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
         audioProcessor.getAPVTS(), "filtertype", filterTypeBox);
+    filterEngineAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getAPVTS(), "filterengine", filterEngineBox);
+    oversamplingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getAPVTS(), "oversampling", oversamplingBox);
     tempoSyncAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         audioProcessor.getAPVTS(), "temposync", tempoSyncButton);
 
+    setOpaque(true);
     setSize(800, 600);
     setResizable(true, true);
     setResizeLimits(600, 450, 1200, 900);
@@ -122,6 +140,11 @@ void FlarksiesisAudioProcessorEditor::setupSlider(juce::Slider& slider, juce::Sl
 }
 
 void FlarksiesisAudioProcessorEditor::paint(juce::Graphics& g)
+{
+    background.draw(g, getWidth(), getHeight(), [this](juce::Graphics& backgroundGraphics) { paintBackground(backgroundGraphics); });
+}
+
+void FlarksiesisAudioProcessorEditor::paintBackground(juce::Graphics& g)
 {
     // Background
     g.fillAll(juce::Colour(0xFF000000));
@@ -152,10 +175,14 @@ void FlarksiesisAudioProcessorEditor::paint(juce::Graphics& g)
 
 void FlarksiesisAudioProcessorEditor::resized()
 {
+    background.invalidate();
+
     auto area = getLocalBounds();
     
-    // Title
-    titleLabel.setBounds(area.removeFromTop(50).reduced(10));
+    // Title, with the load meter on the right
+    auto titleArea = area.removeFromTop(50).reduced(10);
+    loadMeterDisplay.setBounds(titleArea.removeFromRight(230).withSizeKeepingCentre(230, 20));
+    titleLabel.setBounds(titleArea);
     
     // LFO Section
     auto lfoArea = area.removeFromTop(180).reduced(15);
@@ -195,7 +222,12 @@ void FlarksiesisAudioProcessorEditor::resized()
     resonanceSlider.setBounds(resArea.reduced(5));
     
     filterTypeLabel.setBounds(filterArea.removeFromTop(20));
-    filterTypeBox.setBounds(filterArea.removeFromTop(30).reduced(10, 0));
+    auto filterTypeRow = filterArea.removeFromTop(30).reduced(10, 0);
+    filterEngineBox.setBounds(filterTypeRow.removeFromRight(filterTypeRow.getWidth() * 2 / 5));
+    filterTypeBox.setBounds(filterTypeRow.withTrimmedRight(5));
+    filterArea.removeFromTop(10);
+    oversamplingLabel.setBounds(filterArea.removeFromTop(20));
+    oversamplingBox.setBounds(filterArea.removeFromTop(30).reduced(10, 0));
     
     area.removeFromTop(10);
     
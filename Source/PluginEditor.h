@@ -2,14 +2,68 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "PluginProcessor.h"
+#include <tuple>
 
 //==============================================================================
+/**
+    An image of something that changes far less often than it's painted. The
+    content is rendered at the display's pixel scale on the first draw after
+    invalidate() (or a size change) and blitted on every other draw.
+*/
+class CachedLayer
+{
+public:
+    void invalidate() noexcept { valid = false; }
+
+    template <typename PaintFunction>
+    void draw(juce::Graphics& g, int width, int height, PaintFunction&& paintContent)
+    {
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const int pixelWidth = juce::jmax(1, juce::roundToInt(static_cast<float>(width) * scale));
+        const int pixelHeight = juce::jmax(1, juce::roundToInt(static_cast<float>(height) * scale));
+
+        if (image.getWidth() != pixelWidth || image.getHeight() != pixelHeight)
+        {
+            image = juce::Image(juce::Image::ARGB, pixelWidth, pixelHeight, true);
+            valid = false;
+        }
+
+        if (! valid)
+        {
+            image.clear(image.getBounds());
+            juce::Graphics imageGraphics(image);
+            imageGraphics.addTransform(juce::AffineTransform::scale(scale));
+            paintContent(imageGraphics);
+            valid = true;
+        }
+
+        g.drawImageTransformed(image, juce::AffineTransform::scale(1.0f / scale));
+    }
+
+private:
+    juce::Image image;
+    bool valid = false;
+};
+
+//==============================================================================
+/**
+    Scrolling trace of the modulation the audio thread applied: the LFO for the
+    first and last channel, and the cutoff (log scale) behind them. The frames
+    arrive over the processor's telemetry queue, so nothing is synthesised here.
+
+    While audio plays the trace moves with every batch of frames, so it's drawn
+    straight from the history on each repaint rather than cached; the component
+    is opaque, so its repaints never reach the editor behind it.
+*/
 class LFOVisualizer : public juce::Component, public juce::Timer
 {
 public:
-    LFOVisualizer(FlarksiesisAudioProcessor& p) : processor(p)
+    LFOVisualizer(FlarksiesisAudioProcessor& p)
+        : telemetry(p.getModulationTelemetry()),
+          history(static_cast<size_t>(historySeconds * FlarksiesisAudioProcessor::telemetryRateHz))
     {
         // Don't start timer in constructor - wait for component to be fully initialized
+        setOpaque(true);
     }
     
     ~LFOVisualizer() override
@@ -20,73 +74,66 @@ public:
     void visibilityChanged() override
     {
         if (isVisible())
+        {
+            telemetry.clear(); // Stale frames from while we weren't looking
             startTimerHz(30);
+        }
         else
+        {
             stopTimer();
+        }
     }
 
     void paint(juce::Graphics& g) override
     {
         g.fillAll(juce::Colour(0xFF1A1A1A));
-        
-        // Draw waveform
-        juce::Path path;
-        bool firstPoint = true;
-        
-        int waveformIndex = static_cast<int>(*processor.getAPVTS().getRawParameterValue("waveform"));
-        auto waveform = static_cast<FlarksiesisAudioProcessor::LFOWaveform>(waveformIndex);
-        
-        for (int x = 0; x < getWidth(); ++x)
+
+        const float width = static_cast<float>(getWidth());
+        const float height = static_cast<float>(getHeight());
+        const size_t size = history.size();
+        const float step = width / static_cast<float>(size - 1);
+
+        // Oldest frame on the left; history[writePosition] is the oldest
+        auto traceOf = [&](auto valueOf)
         {
-            float phase = static_cast<float>(x) / getWidth();
-            float value = 0.0f;
-            
-            // Simple LFO generation for visualization
-            switch (waveform)
-            {
-                case FlarksiesisAudioProcessor::LFOWaveform::Sine:
-                    value = std::sin(phase * juce::MathConstants<float>::twoPi);
-                    break;
-                case FlarksiesisAudioProcessor::LFOWaveform::Triangle:
-                {
-                    float t = phase * 4.0f;
-                    if (t < 1.0f) value = t;
-                    else if (t < 3.0f) value = 2.0f - t;
-                    else value = t - 4.0f;
-                    break;
-                }
-                case FlarksiesisAudioProcessor::LFOWaveform::Square:
-                    value = phase < 0.5f ? 1.0f : -1.0f;
-                    break;
-                case FlarksiesisAudioProcessor::LFOWaveform::Saw:
-                    value = 2.0f * phase - 1.0f;
-                    break;
-                case FlarksiesisAudioProcessor::LFOWaveform::Random:
-                {
-                    // Use deterministic pseudo-random for visualization
-                    // Avoid getSystemRandom() in paint - not thread safe
-                    juce::Random r(static_cast<juce::int64>(phase * 1000000));
-                    value = std::sin(phase * juce::MathConstants<float>::twoPi * 8.0f) *
-                            (r.nextFloat() * 0.3f + 0.7f);
-                    break;
-                }
-            }
-            
-            float y = getHeight() * 0.5f * (1.0f - value * 0.8f);
-            
-            if (firstPoint)
-            {
-                path.startNewSubPath(static_cast<float>(x), y);
-                firstPoint = false;
-            }
-            else
+            juce::Path path;
+
+            for (size_t i = 0; i < size; ++i)
             {
-                path.lineTo(static_cast<float>(x), y);
+                const auto& frame = history[(writePosition + i) % size];
+                const float x = static_cast<float>(i) * step;
+                const float y = height * 0.5f * (1.0f - valueOf(frame) * 0.8f);
+
+                if (i == 0)
+                    path.startNewSubPath(x, y);
+                else
+                    path.lineTo(x, y);
             }
-        }
-        
+
+            return path;
+        };
+
+        // Cutoff from 20 Hz to 20 kHz, mapped onto the same -1..1 span as the LFO
+        const auto cutoffPosition = [](float hz)
+        {
+            return static_cast<float>(std::log(juce::jlimit(20.0f, 20000.0f, hz) / 20.0f) / std::log(1000.0f)) * 2.0f - 1.0f;
+        };
+
+        g.setColour(juce::Colour(0x66FFFFFF));
+        g.strokePath(traceOf([&](const auto& frame) { return cutoffPosition(frame.cutoff[0]); }), juce::PathStrokeType(1.0f));
+
+        g.setColour(juce::Colour(0x88FF6600));
+        g.strokePath(traceOf([](const auto& frame) { return frame.lfo[1]; }), juce::PathStrokeType(1.5f));
+
         g.setColour(juce::Colour(0xFFFF6600));
-        g.strokePath(path, juce::PathStrokeType(2.0f));
+        g.strokePath(traceOf([](const auto& frame) { return frame.lfo[0]; }), juce::PathStrokeType(2.0f));
+
+        // Current cutoff
+        const float latestCutoff = history[(writePosition + size - 1) % size].cutoff[0];
+        g.setFont(juce::Font(11.0f));
+        g.drawText(latestCutoff >= 1000.0f ? juce::String(latestCutoff / 1000.0f, 2) + " kHz"
+                                           : juce::String(juce::roundToInt(latestCutoff)) + " Hz",
+                   getLocalBounds().reduced(4), juce::Justification::topLeft);
         
         // Draw border
         g.setColour(juce::Colour(0xFFFF6600));
@@ -95,11 +142,114 @@ public:
 
     void timerCallback() override
     {
-        repaint();
+        FlarksiesisAudioProcessor::ModulationFrame frame;
+        bool received = false;
+
+        while (telemetry.pop(frame))
+        {
+            history[writePosition] = frame;
+            writePosition = (writePosition + 1) % history.size();
+            received = true;
+        }
+
+        if (received)
+            repaint();
+    }
+
+private:
+    static constexpr double historySeconds = 3.0;
+
+    FlarksiesisAudioProcessor::ModulationTelemetry& telemetry;
+    std::vector<FlarksiesisAudioProcessor::ModulationFrame> history;
+    size_t writePosition = 0;
+};
+
+//==============================================================================
+/** Shows how much of the buffer period processBlock uses; measuring runs while this exists. */
+class LoadMeterDisplay : public juce::Component, public juce::Timer
+{
+public:
+    LoadMeterDisplay(FlarksiesisAudioProcessor& p) : meter(p.getLoadMeter()), reader(meter)
+    {
+        setOpaque(true);
+    }
+
+    ~LoadMeterDisplay() override
+    {
+        stopTimer();
+    }
+
+    void visibilityChanged() override
+    {
+        if (isVisible())
+            startTimerHz(10);
+        else
+            stopTimer();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+        g.fillAll(juce::Colour(0xFF000000)); // The editor's background, so the rounded corners can stay opaque
+        g.setColour(juce::Colour(0xFF1A1A1A));
+        g.fillRoundedRectangle(bounds, 3.0f);
+
+        // Mean as the bar, p99 as a tick; red for a second after any block runs over its budget
+        const auto bar = bounds.reduced(2.0f);
+        const auto colour = overBudgetRecently ? juce::Colours::red : juce::Colour(0xFFFF6600);
+        const float meanWidth = bar.getWidth() * static_cast<float>(juce::jmin(1.0, statistics.meanLoad));
+        const float p99X = bar.getX() + bar.getWidth() * static_cast<float>(juce::jmin(1.0, statistics.p99Load));
+
+        g.setColour(colour.withAlpha(0.35f));
+        g.fillRect(bar.withWidth(meanWidth));
+        g.setColour(colour);
+        g.drawVerticalLine(static_cast<int>(p99X), bar.getY(), bar.getBottom());
+
+        g.setFont(juce::Font(11.0f));
+        g.drawText(juce::String::formatted("DSP %.0f%%  p99 %.0f%%  max %.0f%%  over %llu",
+                                           statistics.meanLoad * 100.0, statistics.p99Load * 100.0,
+                                           statistics.maxLoad * 100.0,
+                                           static_cast<unsigned long long>(statistics.numOverBudget)),
+                   getLocalBounds().reduced(4, 0), juce::Justification::centred);
+
+        g.drawRoundedRectangle(bounds.reduced(0.5f), 3.0f, 1.0f);
+    }
+
+    // Click to start the statistics again
+    void mouseUp(const juce::MouseEvent&) override
+    {
+        meter.reset();
+    }
+
+    void timerCallback() override
+    {
+        const auto previousOverBudget = statistics.numOverBudget;
+        statistics = meter.getStatistics();
+
+        if (statistics.numOverBudget > previousOverBudget)
+            overBudgetTicks = 10;
+        else if (overBudgetTicks > 0)
+            --overBudgetTicks;
+
+        // Only repaint when something shown has changed
+        const auto shown = std::make_tuple(juce::roundToInt(statistics.meanLoad * 100.0), juce::roundToInt(statistics.p99Load * 100.0),
+                                           juce::roundToInt(statistics.maxLoad * 100.0), statistics.numOverBudget, overBudgetTicks > 0);
+
+        if (shown != lastShown)
+        {
+            lastShown = shown;
+            overBudgetRecently = overBudgetTicks > 0;
+            repaint();
+        }
     }
 
 private:
-    FlarksiesisAudioProcessor& processor;
+    flarksiesis::LoadMeter& meter;
+    flarksiesis::LoadMeter::ScopedReader reader;
+    flarksiesis::LoadMeter::Statistics statistics;
+    int overBudgetTicks = 0;
+    bool overBudgetRecently = false;
+    std::tuple<int, int, int, std::uint64_t, bool> lastShown {-1, -1, -1, 0, false};
 };
 
 //==============================================================================
@@ -119,15 +269,16 @@ private:
     // UI Components
     juce::Slider rateSlider, depthSlider, frequencySlider, resonanceSlider;
     juce::Slider mixSlider, stereoWidthSlider, feedbackSlider;
-    juce::ComboBox waveformBox, filterTypeBox;
+    juce::ComboBox waveformBox, filterTypeBox, filterEngineBox, oversamplingBox;
     juce::ToggleButton tempoSyncButton;
     
     juce::Label rateLabel, depthLabel, waveformLabel, tempoSyncLabel;
-    juce::Label frequencyLabel, resonanceLabel, filterTypeLabel;
+    juce::Label frequencyLabel, resonanceLabel, filterTypeLabel, oversamplingLabel;
     juce::Label mixLabel, stereoWidthLabel, feedbackLabel;
     juce::Label titleLabel;
     
     LFOVisualizer lfoVisualizer;
+    LoadMeterDisplay loadMeterDisplay;
 
     // Attachments
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> rateAttachment;
@@ -139,10 +290,16 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> feedbackAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> waveformAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> filterTypeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> filterEngineAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> tempoSyncAttachment;
 
     void setupLabel(juce::Label& label, const juce::String& text);
     void setupSlider(juce::Slider& slider, juce::Slider::SliderStyle style);
+
+    // The section panels only change with the editor's size
+    CachedLayer background;
+    void paintBackground(juce::Graphics& g);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FlarksiesisAudioProcessorEditor)
 };
@@ -1,5 +1,6 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "RealtimeGuard.h"
 
 //==============================================================================
 FlarksiesisAudioProcessor::FlarksiesisAudioProcessor()
@@ -17,10 +18,44 @@ FlarksiesisAudioProcessor::FlarksiesisAudioProcessor()
 #endif
     apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
+    parameters.rate = apvts.getRawParameterValue("rate");
+    parameters.depth = apvts.getRawParameterValue("depth");
+    parameters.waveform = apvts.getRawParameterValue("waveform");
+    parameters.tempoSync = apvts.getRawParameterValue("temposync");
+    parameters.frequency = apvts.getRawParameterValue("frequency");
+    parameters.resonance = apvts.getRawParameterValue("resonance");
+    parameters.filterType = apvts.getRawParameterValue("filtertype");
+    parameters.mix = apvts.getRawParameterValue("mix");
+    parameters.stereoWidth = apvts.getRawParameterValue("stereowidth");
+    parameters.feedback = apvts.getRawParameterValue("feedback");
+    parameters.oversampling = apvts.getRawParameterValue("oversampling");
+    parameters.filterEngine = apvts.getRawParameterValue("filterengine");
+
+    for (int i = 0; i < numModulationLFOs; ++i)
+    {
+        const auto prefix = "lfo" + juce::String(i + 2);
+        parameters.modulationRates[static_cast<size_t>(i)] = apvts.getRawParameterValue(prefix + "rate");
+        parameters.modulationWaveforms[static_cast<size_t>(i)] = apvts.getRawParameterValue(prefix + "waveform");
+    }
+
+    for (int i = 0; i < numRoutes; ++i)
+    {
+        const auto prefix = "mod" + juce::String(i + 1);
+        parameters.routeSources[static_cast<size_t>(i)] = apvts.getRawParameterValue(prefix + "source");
+        parameters.routeTargets[static_cast<size_t>(i)] = apvts.getRawParameterValue(prefix + "target");
+        parameters.routeDepths[static_cast<size_t>(i)] = apvts.getRawParameterValue(prefix + "depth");
+    }
+
+    effect.setParameterSource(this);
+    effect.setTelemetry(&modulationTelemetry);
+
+    // Latency changes from the audio thread are passed on to the host from the message thread
+    startTimerHz(10);
 }
 
 FlarksiesisAudioProcessor::~FlarksiesisAudioProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -49,6 +84,9 @@ juce::AudioProcessorValueTreeState::ParameterLayout FlarksiesisAudioProcessor::c
         "filtertype", "Filter Type",
         juce::StringArray{"Lowpass", "Highpass", "Bandpass", "Notch", 
                          "Allpass", "LP 12dB", "HP 12dB", "BP 12dB"}, 0));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "oversampling", "Oversampling",
+        juce::StringArray{"Off", "2x", "4x"}, 0));
 
     // Mix Parameters
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
@@ -58,6 +96,42 @@ juce::AudioProcessorValueTreeState::ParameterLayout FlarksiesisAudioProcessor::c
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "feedback", "Feedback", 0.0f, 0.95f, 0.0f));
 
+    // Modulation Matrix
+    const Parameters defaults;
+
+    for (int i = 0; i < numModulationLFOs; ++i)
+    {
+        const auto id = "lfo" + juce::String(i + 2);
+        const auto name = "LFO " + juce::String(i + 2);
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            id + "rate", name + " Rate", 0.01f, 20.0f, defaults.modulationRates[static_cast<size_t>(i)]));
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            id + "waveform", name + " Waveform",
+            juce::StringArray{"Sine", "Triangle", "Square", "Saw", "Random"},
+            static_cast<int>(defaults.modulationWaveforms[static_cast<size_t>(i)])));
+    }
+
+    for (int i = 0; i < numRoutes; ++i)
+    {
+        const auto id = "mod" + juce::String(i + 1);
+        const auto name = "Mod " + juce::String(i + 1);
+
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            id + "source", name + " Source",
+            juce::StringArray{"LFO 1", "LFO 2", "LFO 3", "LFO 4"}, 0));
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            id + "target", name + " Target",
+            juce::StringArray{"Cutoff", "Resonance", "Dry/Wet", "Stereo Width", "Feedback"}, 0));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            id + "depth", name + " Depth", -1.0f, 1.0f, 0.0f));
+    }
+
+    // Filter engine, after the matrix so existing automation keeps its parameter indices
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "filterengine", "Filter Engine",
+        juce::StringArray{"Biquad", "SVF"}, flarksiesis::biquadEngine));
+
     return {params.begin(), params.end()};
 }
 
@@ -96,52 +170,130 @@ bool FlarksiesisAudioProcessor::isMidiEffect() const
 
 double FlarksiesisAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return effect.getTailLengthSeconds(readParameters());
 }
 
+//==============================================================================
+// Rate, depth, waveform, tempo sync, cutoff, resonance, filter type, mix, stereo width, feedback, oversampling
+const std::array<FlarksiesisAudioProcessor::Program, 5> FlarksiesisAudioProcessor::factoryPrograms {{
+    { "Init",                  { 2.0f, 0.5f, LFOWaveform::Sine,     false, 1000.0f, 0.707f, 0, 0.5f, 1.0f, 0.0f, 0 } },
+    { "Subtle Movement",       { 0.2f, 0.2f, LFOWaveform::Sine,     false, 1000.0f, 0.707f, 0, 0.3f, 1.0f, 0.0f, 0 } },
+    { "Classic Phaser",        { 0.5f, 0.5f, LFOWaveform::Triangle, false, 1000.0f, 0.707f, 4, 0.5f, 1.0f, 0.5f, 0 } },
+    { "Rhythmic Chop",         { 4.0f, 0.8f, LFOWaveform::Square,   false, 1000.0f, 0.707f, 0, 0.7f, 1.0f, 0.0f, 0 } },
+    { "Experimental Textures", { 8.0f, 0.9f, LFOWaveform::Random,   false, 1000.0f, 0.707f, 2, 0.5f, 1.5f, 0.7f, 0 } },
+}};
+
 int FlarksiesisAudioProcessor::getNumPrograms()
 {
-    return 1;
+    return static_cast<int>(factoryPrograms.size());
 }
 
 int FlarksiesisAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram;
 }
 
 void FlarksiesisAudioProcessor::setCurrentProgram(int index)
 {
+    if (! juce::isPositiveAndBelow(index, getNumPrograms()))
+        return;
+
+    // Selecting a program reloads it, the current one included, except when a host re-selects the
+    // saved program right after restoring a state: while the parameters still hold what the state
+    // restored, that would throw away the edits the state was saved with
+    const bool reselectAfterRestore = index == currentProgram && ! restoredValues.empty()
+                                   && restoredValues == getParameterValues();
+    restoredValues.clear();
+
+    if (reselectAfterRestore)
+        return;
+
+    currentProgram = index;
+    writeState([this, index] { writeParameters(factoryPrograms[static_cast<size_t>(index)].parameters); });
 }
 
 const juce::String FlarksiesisAudioProcessor::getProgramName(int index)
 {
-    return {};
+    if (! juce::isPositiveAndBelow(index, getNumPrograms()))
+        return {};
+
+    return factoryPrograms[static_cast<size_t>(index)].name;
 }
 
 void FlarksiesisAudioProcessor::changeProgramName(int index, const juce::String& newName)
 {
+    // Factory programs keep their names; edited settings are saved with the host's state
+    juce::ignoreUnused(index, newName);
 }
 
-//==============================================================================
-void FlarksiesisAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+void FlarksiesisAudioProcessor::writeParameters(const Parameters& values)
 {
-    currentSampleRate = sampleRate;
-    
-    // Reset filter states
-    for (auto& state : filterStates)
+    const std::pair<const char*, float> assignments[] {
+        { "rate", values.rate },
+        { "depth", values.depth },
+        { "waveform", static_cast<float>(values.waveform) },
+        { "temposync", values.tempoSync ? 1.0f : 0.0f },
+        { "frequency", values.frequency },
+        { "resonance", values.resonance },
+        { "filtertype", static_cast<float>(values.filterType) },
+        { "mix", values.mix },
+        { "stereowidth", values.stereoWidth },
+        { "feedback", values.feedback },
+        { "oversampling", static_cast<float>(values.oversampling) },
+        { "filterengine", static_cast<float>(values.filterEngine) },
+    };
+
+    auto set = [this](const juce::String& id, float value)
+    {
+        if (auto* parameter = apvts.getParameter(id))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    };
+
+    for (const auto& [id, value] : assignments)
+        set(id, value);
+
+    for (size_t i = 0; i < static_cast<size_t>(numModulationLFOs); ++i)
     {
-        state.z.fill(0.0f);
+        const auto prefix = "lfo" + juce::String(static_cast<int>(i) + 2);
+        set(prefix + "rate", values.modulationRates[i]);
+        set(prefix + "waveform", static_cast<float>(values.modulationWaveforms[i]));
     }
-    
-    // Reset LFO
-    lfoPhase = 0.0f;
-    lastRandomValue = 0.0f;
-    nextRandomValue = 0.0f;
-    randomInterpolation = 0.0f;
+
+    for (size_t i = 0; i < static_cast<size_t>(numRoutes); ++i)
+    {
+        const auto prefix = "mod" + juce::String(static_cast<int>(i) + 1);
+        set(prefix + "source", static_cast<float>(values.routes[i].source));
+        set(prefix + "target", static_cast<float>(values.routes[i].target));
+        set(prefix + "depth", values.routes[i].depth);
+    }
+}
+
+template <typename Function>
+void FlarksiesisAudioProcessor::writeState(Function&& write)
+{
+    stateSequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    write();
+    stateSequence.fetch_add(1, std::memory_order_release);
+}
+
+//==============================================================================
+void FlarksiesisAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    loadMeter.prepare(sampleRate);
+
+    // The ramps start at the current values, so playback doesn't begin with a sweep
+    appliedStateSequence = stateSequence.load(std::memory_order_acquire);
+    effect.setParameters(readParameters());
+
+    // Audio buffers, filter state and oversampling in the precision the host will process in
+    effect.prepare(sampleRate, getTotalNumInputChannels(), samplesPerBlock, isUsingDoublePrecision());
+    setLatencySamples(effect.getLatencySamples());
 }
 
 void FlarksiesisAudioProcessor::releaseResources()
 {
+    effect.release();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -151,8 +303,11 @@ bool FlarksiesisAudioProcessor::isBusesLayoutSupported(const BusesLayout& layout
     juce::ignoreUnused(layouts);
     return true;
 #else
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout (mono, stereo, surround, immersive, ambisonic, discrete) up to maxChannels;
+    // every channel gets its own filter state and LFO phase
+    const int numChannels = layouts.getMainOutputChannelSet().size();
+
+    if (layouts.getMainOutputChannelSet().isDisabled() || numChannels > maxChannels)
         return false;
 
 #if ! JucePlugin_IsSynth
@@ -166,290 +321,110 @@ bool FlarksiesisAudioProcessor::isBusesLayoutSupported(const BusesLayout& layout
 #endif
 
 //==============================================================================
-float FlarksiesisAudioProcessor::generateLFO(LFOWaveform waveform, float phase)
+FlarksiesisAudioProcessor::Parameters FlarksiesisAudioProcessor::readParameters() const noexcept
 {
-    switch (waveform)
+    Parameters params;
+    params.rate = parameters.rate->load(std::memory_order_relaxed);
+    params.depth = parameters.depth->load(std::memory_order_relaxed);
+    params.waveform = static_cast<LFOWaveform>(static_cast<int>(parameters.waveform->load(std::memory_order_relaxed)));
+    params.tempoSync = parameters.tempoSync->load(std::memory_order_relaxed) > 0.5f;
+    params.frequency = parameters.frequency->load(std::memory_order_relaxed);
+    params.resonance = parameters.resonance->load(std::memory_order_relaxed);
+    params.filterType = static_cast<int>(parameters.filterType->load(std::memory_order_relaxed));
+    params.mix = parameters.mix->load(std::memory_order_relaxed);
+    params.stereoWidth = parameters.stereoWidth->load(std::memory_order_relaxed);
+    params.feedback = parameters.feedback->load(std::memory_order_relaxed);
+    params.oversampling = static_cast<int>(parameters.oversampling->load(std::memory_order_relaxed));
+    params.filterEngine = static_cast<int>(parameters.filterEngine->load(std::memory_order_relaxed));
+
+    for (size_t i = 0; i < static_cast<size_t>(numModulationLFOs); ++i)
     {
-        case LFOWaveform::Sine:
-            return std::sin(phase * juce::MathConstants<float>::twoPi);
-            
-        case LFOWaveform::Triangle:
-        {
-            float t = phase * 4.0f;
-            if (t < 1.0f) return t;
-            if (t < 3.0f) return 2.0f - t;
-            return t - 4.0f;
-        }
-        
-        case LFOWaveform::Square:
-            return phase < 0.5f ? 1.0f : -1.0f;
-            
-        case LFOWaveform::Saw:
-            return 2.0f * phase - 1.0f;
-            
-        case LFOWaveform::Random:
-        {
-            // Smooth random interpolation
-            return lastRandomValue + (nextRandomValue - lastRandomValue) * randomInterpolation;
-        }
-            
-        default:
-            return 0.0f;
+        params.modulationRates[i] = parameters.modulationRates[i]->load(std::memory_order_relaxed);
+        params.modulationWaveforms[i] = static_cast<LFOWaveform>(static_cast<int>(parameters.modulationWaveforms[i]->load(std::memory_order_relaxed)));
     }
-}
 
-float FlarksiesisAudioProcessor::getEffectiveRate(float rateParam, bool tempoSync)
-{
-    if (!tempoSync)
-        return rateParam;
-    
-    // Get tempo from host
-    auto playHead = getPlayHead();
-    if (playHead != nullptr)
+    for (size_t i = 0; i < static_cast<size_t>(numRoutes); ++i)
     {
-        juce::Optional<juce::AudioPlayHead::PositionInfo> posInfo = playHead->getPosition();
-        if (posInfo.hasValue() && posInfo->getBpm().hasValue())
-        {
-            double bpm = *posInfo->getBpm();
-            // Map rate parameter to musical divisions
-            float division = std::pow(2.0f, std::floor(rateParam * 4.0f - 8.0f));
-            return static_cast<float>((bpm / 60.0) * division);
-        }
+        params.routes[i].source = static_cast<int>(parameters.routeSources[i]->load(std::memory_order_relaxed));
+        params.routes[i].target = static_cast<int>(parameters.routeTargets[i]->load(std::memory_order_relaxed));
+        params.routes[i].depth = parameters.routeDepths[i]->load(std::memory_order_relaxed);
     }
-    
-    return rateParam;
-}
-
-void FlarksiesisAudioProcessor::processFilter(float* buffer, int numSamples, int channel,
-                                              float frequency, float resonance, int filterType)
-{
-    auto& state = filterStates[channel];
-    
-    // Calculate filter coefficients
-    float omega = juce::MathConstants<float>::twoPi * frequency / static_cast<float>(currentSampleRate);
-    float cosOmega = std::cos(omega);
-    float sinOmega = std::sin(omega);
-    float alpha = sinOmega / (2.0f * resonance);
-    
-    float b0, b1, b2, a0, a1, a2;
-    
-    switch (filterType)
-    {
-        case 0: // Lowpass 24dB
-        {
-            b0 = (1.0f - cosOmega) / 2.0f;
-            b1 = 1.0f - cosOmega;
-            b2 = (1.0f - cosOmega) / 2.0f;
-            a0 = 1.0f + alpha;
-            a1 = -2.0f * cosOmega;
-            a2 = 1.0f - alpha;
-            break;
-        }
-        case 1: // Highpass 24dB
-        {
-            b0 = (1.0f + cosOmega) / 2.0f;
-            b1 = -(1.0f + cosOmega);
-            b2 = (1.0f + cosOmega) / 2.0f;
-            a0 = 1.0f + alpha;
-            a1 = -2.0f * cosOmega;
-            a2 = 1.0f - alpha;
-            break;
-        }
-        case 2: // Bandpass
-        {
-            b0 = alpha;
-            b1 = 0.0f;
-            b2 = -alpha;
-            a0 = 1.0f + alpha;
-            a1 = -2.0f * cosOmega;
-            a2 = 1.0f - alpha;
-            break;
-        }
-        case 3: // Notch
-        {
-            b0 = 1.0f;
-            b1 = -2.0f * cosOmega;
-            b2 = 1.0f;
-            a0 = 1.0f + alpha;
-            a1 = -2.0f * cosOmega;
-            a2 = 1.0f - alpha;
-            break;
-        }
-        case 4: // Allpass
-        {
-            b0 = 1.0f - alpha;
-            b1 = -2.0f * cosOmega;
-            b2 = 1.0f + alpha;
-            a0 = 1.0f + alpha;
-            a1 = -2.0f * cosOmega;
-            a2 = 1.0f - alpha;
-            break;
-        }
-        case 5: // Lowpass 12dB
-        {
-            float k = std::tan(omega / 2.0f);
-            float norm = 1.0f / (1.0f + k / resonance + k * k);
-            b0 = k * k * norm;
-            b1 = 2.0f * b0;
-            b2 = b0;
-            a0 = 1.0f;
-            a1 = 2.0f * (k * k - 1.0f) * norm;
-            a2 = (1.0f - k / resonance + k * k) * norm;
-            break;
-        }
-        case 6: // Highpass 12dB
-        {
-            float k = std::tan(omega / 2.0f);
-            float norm = 1.0f / (1.0f + k / resonance + k * k);
-            b0 = norm;
-            b1 = -2.0f * b0;
-            b2 = b0;
-            a0 = 1.0f;
-            a1 = 2.0f * (k * k - 1.0f) * norm;
-            a2 = (1.0f - k / resonance + k * k) * norm;
-            break;
-        }
-        case 7: // Bandpass 12dB
-        {
-            float k = std::tan(omega / 2.0f);
-            float norm = 1.0f / (1.0f + k / resonance + k * k);
-            b0 = k / resonance * norm;
-            b1 = 0.0f;
-            b2 = -b0;
-            a0 = 1.0f;
-            a1 = 2.0f * (k * k - 1.0f) * norm;
-            a2 = (1.0f - k / resonance + k * k) * norm;
-            break;
-        }
-        default:
-            b0 = 1.0f; b1 = 0.0f; b2 = 0.0f;
-            a0 = 1.0f; a1 = 0.0f; a2 = 0.0f;
-    }
-    
-    // Normalize coefficients
-    b0 /= a0;
-    b1 /= a0;
-    b2 /= a0;
-    a1 /= a0;
-    a2 /= a0;
-    
-    // Process samples
-    for (int i = 0; i < numSamples; ++i)
+
+    return params;
+}
+
+void FlarksiesisAudioProcessor::timerCallback()
+{
+    const int latency = effect.getLatencySamples();
+
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+}
+
+double FlarksiesisAudioProcessor::getHostTempo()
+{
+    if (auto* playHead = getPlayHead())
     {
-        float input = buffer[i];
-        float output = b0 * input + b1 * state.z[0] + b2 * state.z[1]
-                                  - a1 * state.z[2] - a2 * state.z[3];
-        
-        // Update state
-        state.z[1] = state.z[0];
-        state.z[0] = input;
-        state.z[3] = state.z[2];
-        state.z[2] = output;
-        
-        buffer[i] = output;
+        const auto position = playHead->getPosition();
+
+        if (position.hasValue() && position->getBpm().hasValue())
+            return *position->getBpm();
     }
+
+    return 0.0;
 }
 
-void FlarksiesisAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+void FlarksiesisAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
 {
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
-    
-    const int numSamples = buffer.getNumSamples();
-    
-    // Safety check
-    if (numSamples <= 0 || totalNumInputChannels <= 0)
-        return;
+    processSamples(buffer);
+}
 
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear(i, 0, numSamples);
-
-    // Get parameters
-    float rate = getEffectiveRate(*apvts.getRawParameterValue("rate"), 
-                                  *apvts.getRawParameterValue("temposync") > 0.5f);
-    float depth = *apvts.getRawParameterValue("depth");
-    int waveformIndex = static_cast<int>(*apvts.getRawParameterValue("waveform"));
-    LFOWaveform waveform = static_cast<LFOWaveform>(waveformIndex);
-    float frequency = *apvts.getRawParameterValue("frequency");
-    float resonance = *apvts.getRawParameterValue("resonance");
-    int filterType = static_cast<int>(*apvts.getRawParameterValue("filtertype"));
-    float mix = *apvts.getRawParameterValue("mix");
-    float stereoWidth = *apvts.getRawParameterValue("stereowidth");
-    float feedback = *apvts.getRawParameterValue("feedback");
-
-    float phaseIncrement = rate / static_cast<float>(currentSampleRate);
-
-    // Create dry buffer for mixing
-    juce::AudioBuffer<float> dryBuffer(totalNumInputChannels, numSamples);
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
-        dryBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
-
-    // Process each channel
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+void FlarksiesisAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+    processSamples(buffer);
+}
+
+template <typename SampleType>
+void FlarksiesisAudioProcessor::processSamples(juce::AudioBuffer<SampleType>& buffer)
+{
+    FLARKSIESIS_REALTIME_SCOPE("FlarksiesisAudioProcessor::processBlock");
+    const flarksiesis::LoadMeter::ScopedMeasurement loadMeasurement(loadMeter, buffer.getNumSamples());
+    const int totalNumInputChannels = getTotalNumInputChannels();
+
+    for (auto i = totalNumInputChannels; i < getTotalNumOutputChannels(); ++i)
+        buffer.clear(i, 0, buffer.getNumSamples());
+
+    // The effect calls updateParameters() back on every line of its parameter grid
+    effect.process(buffer.getArrayOfWritePointers(), juce::jmin(totalNumInputChannels, buffer.getNumChannels()),
+                   buffer.getNumSamples());
+}
+
+void FlarksiesisAudioProcessor::updateParameters(flarksiesis::Effect& target) noexcept
+{
+    // Read the parameters only if no program or state was being written meanwhile; otherwise the
+    // last complete snapshot carries on, and the new one is picked up at the next grid line
+    const auto sequence = stateSequence.load(std::memory_order_acquire);
+
+    if ((sequence & 1u) == 0)
     {
-        auto* channelData = buffer.getWritePointer(channel);
-        float localPhase = lfoPhase;
-        
-        // Add phase offset for stereo width
-        if (channel == 1 && totalNumInputChannels == 2)
-            localPhase = std::fmod(localPhase + (1.0f - stereoWidth) * 0.5f, 1.0f);
-
-        for (int sample = 0; sample < numSamples; ++sample)
+        const auto params = readParameters();
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (stateSequence.load(std::memory_order_relaxed) == sequence)
         {
-            // Generate LFO value
-            if (waveform == LFOWaveform::Random)
+            if (sequence != appliedStateSequence)
+            {
+                appliedStateSequence = sequence;
+                target.changeProgram(params);
+            }
+            else
             {
-                // Update random values at phase reset
-                if (localPhase < phaseIncrement)
-                {
-                    lastRandomValue = nextRandomValue;
-                    nextRandomValue = randomGenerator.nextFloat() * 2.0f - 1.0f;
-                    randomInterpolation = 0.0f;
-                }
-                randomInterpolation = localPhase / (1.0f / rate * static_cast<float>(currentSampleRate));
+                target.setParameters(params);
             }
-            
-            float lfoValue = generateLFO(waveform, localPhase);
-            
-            // Apply LFO to frequency
-            float modulatedFreq = frequency * std::pow(2.0f, lfoValue * depth * 4.0f);
-            modulatedFreq = juce::jlimit(20.0f, 20000.0f, modulatedFreq);
-            
-            // Simple one-pole filter for smooth modulation
-            static float smoothedFreq = frequency;
-            smoothedFreq = smoothedFreq * 0.95f + modulatedFreq * 0.05f;
-            
-            // Store for filtering
-            float tempBuffer[1] = {channelData[sample]};
-            processFilter(tempBuffer, 1, channel, smoothedFreq, resonance, filterType);
-            channelData[sample] = tempBuffer[0];
-            
-            // Apply feedback
-            if (feedback > 0.0f && sample > 0)
-                channelData[sample] += channelData[sample - 1] * feedback;
-            
-            // Advance phase
-            localPhase += phaseIncrement;
-            if (localPhase >= 1.0f)
-                localPhase -= 1.0f;
         }
     }
 
-    // Update global phase
-    lfoPhase += phaseIncrement * numSamples;
-    if (lfoPhase >= 1.0f)
-        lfoPhase -= 1.0f;
-
-    // Mix dry and wet
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
-    {
-        auto* channelData = buffer.getWritePointer(channel);
-        auto* dryData = dryBuffer.getReadPointer(channel);
-        
-        for (int sample = 0; sample < numSamples; ++sample)
-            channelData[sample] = dryData[sample] * (1.0f - mix) + channelData[sample] * mix;
-    }
+    target.setTempo(getHostTempo());
 }
 
 //==============================================================================
@@ -466,18 +441,97 @@ juce::AudioProcessorEditor* FlarksiesisAudioProcessor::createEditor()
 //==============================================================================
 void FlarksiesisAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Every parameter comes from the APVTS layout, so all of them are ranged
+    const auto& allParameters = getParameters();
+
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(stateMagic);
+    stream.writeInt(stateVersion);
+    stream.writeInt(currentProgram);
+    stream.writeInt(allParameters.size());
+
+    for (auto* parameter : allParameters)
+    {
+        auto* ranged = static_cast<juce::RangedAudioParameter*>(parameter);
+        stream.writeString(ranged->getParameterID());
+        stream.writeFloat(ranged->convertFrom0to1(ranged->getValue()));
+    }
 }
 
 void FlarksiesisAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    if (readBinaryState(data, sizeInBytes))
+    {
+        restoredValues = getParameterValues();
+        return;
+    }
+
+    // Saved as XML by 2.0.0
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
     if (xmlState.get() != nullptr)
+    {
         if (xmlState->hasTagName(apvts.state.getType()))
-            apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+        {
+            writeState([&] { apvts.replaceState(juce::ValueTree::fromXml(*xmlState)); });
+            restoredValues = getParameterValues();
+        }
+    }
+}
+
+std::vector<float> FlarksiesisAudioProcessor::getParameterValues() const
+{
+    std::vector<float> values;
+
+    for (auto* parameter : getParameters())
+        values.push_back(parameter->getValue());
+
+    return values;
+}
+
+bool FlarksiesisAudioProcessor::readBinaryState(const void* data, int sizeInBytes)
+{
+    if (data == nullptr || sizeInBytes < 16)
+        return false;
+
+    juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+
+    // Later versions may only append to this layout, so anything from version 1 on reads
+    if (stream.readInt() != stateMagic || stream.readInt() < 1)
+        return false;
+
+    const int program = stream.readInt();
+    const int numValues = stream.readInt();
+
+    std::vector<std::pair<juce::String, float>> values;
+
+    for (int i = 0; i < numValues; ++i)
+    {
+        auto id = stream.readString();
+
+        if (stream.getNumBytesRemaining() < 4)
+            return false;
+
+        values.emplace_back(std::move(id), stream.readFloat());
+    }
+
+    currentProgram = juce::jlimit(0, getNumPrograms() - 1, program);
+
+    // Parameters missing from the data go back to their defaults, as replaceState() does
+    writeState([&]
+    {
+        for (auto* parameter : getParameters())
+        {
+            auto* ranged = static_cast<juce::RangedAudioParameter*>(parameter);
+            const auto id = ranged->getParameterID();
+            const auto found = std::find_if(values.begin(), values.end(), [&](const auto& value) { return value.first == id; });
+
+            ranged->setValueNotifyingHost(found != values.end() ? ranged->convertTo0to1(found->second)
+                                                                : ranged->getDefaultValue());
+        }
+    });
+
+    return true;
 }
 
 //==============================================================================
@@ -1,12 +1,21 @@
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
-#include <juce_dsp/juce_dsp.h>
+#include "DSP/Effect.h"
+#include "LoadMeter.h"
 #include <array>
-#include <cmath>
+#include <vector>
 
 //==============================================================================
-class FlarksiesisAudioProcessor : public juce::AudioProcessor
+/**
+    The plugin: an adapter between the host and flarksiesis::Effect, which does
+    all the processing. This side owns the parameter tree, programs, state,
+    tempo, latency reporting, load metering and the editor, and hands the
+    effect a plain parameter struct every time it takes parameters.
+*/
+class FlarksiesisAudioProcessor : public juce::AudioProcessor,
+                                  private flarksiesis::Effect::ParameterSource,
+                                  private juce::Timer
 {
 public:
     //==============================================================================
@@ -22,6 +31,8 @@ public:
 #endif
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -48,44 +59,105 @@ public:
 
     //==============================================================================
     juce::AudioProcessorValueTreeState& getAPVTS() { return apvts; }
+
+    // Number of samples between filter coefficient updates; applied at the next prepareToPlay()
+    void setControlInterval(int samples) { effect.setControlInterval(samples); }
+    int getControlInterval() const { return effect.getControlInterval(); }
+
+    // Callback timing; measuring is on while something holds a LoadMeter::ScopedReader
+    flarksiesis::LoadMeter& getLoadMeter() { return loadMeter; }
+
+    // Blocks passed through as silence, without running the DSP, since prepareToPlay()
+    std::uint64_t getNumSkippedBlocks() const noexcept { return effect.getNumSkippedBlocks(); }
+
+    // The modulation the audio thread applied, for display; about telemetryRateHz frames per second
+    using ModulationFrame = flarksiesis::Effect::ModulationFrame;
+    using ModulationTelemetry = flarksiesis::Effect::ModulationTelemetry;
+    static constexpr double telemetryRateHz = flarksiesis::Effect::telemetryRateHz;
+
+    // Single consumer: only the editor should pop from this
+    ModulationTelemetry& getModulationTelemetry() { return modulationTelemetry; }
     
-    // LFO waveform types
-    enum class LFOWaveform
-    {
-        Sine = 0,
-        Triangle,
-        Square,
-        Saw,
-        Random
-    };
+    // Largest channel count accepted on the main bus
+    static constexpr int maxChannels = flarksiesis::Effect::maxChannels;
+
+    using LFOWaveform = flarksiesis::LFOWaveform;
 
 private:
     //==============================================================================
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
-    
-    // DSP State
-    double currentSampleRate = 44100.0;
-    
-    // LFO State
-    float lfoPhase = 0.0f;
-    float lastRandomValue = 0.0f;
-    float nextRandomValue = 0.0f;
-    float randomInterpolation = 0.0f;
-    juce::Random randomGenerator;  // Per-instance random generator for thread safety
-    
-    // Filter State (per channel)
-    struct FilterState
+
+    using Parameters = flarksiesis::Effect::Parameters;
+    static constexpr int numModulationLFOs = flarksiesis::Effect::numModulationLFOs;
+    static constexpr int numRoutes = flarksiesis::Effect::numRoutes;
+
+    // Parameter values, resolved once so the audio thread never looks them up by name
+    struct ParameterHandles
     {
-        std::array<float, 4> z = {0.0f}; // State variables
+        std::atomic<float>* rate = nullptr;
+        std::atomic<float>* depth = nullptr;
+        std::atomic<float>* waveform = nullptr;
+        std::atomic<float>* tempoSync = nullptr;
+        std::atomic<float>* frequency = nullptr;
+        std::atomic<float>* resonance = nullptr;
+        std::atomic<float>* filterType = nullptr;
+        std::atomic<float>* mix = nullptr;
+        std::atomic<float>* stereoWidth = nullptr;
+        std::atomic<float>* feedback = nullptr;
+        std::atomic<float>* oversampling = nullptr;
+        std::atomic<float>* filterEngine = nullptr;
+
+        std::array<std::atomic<float>*, numModulationLFOs> modulationRates {};
+        std::array<std::atomic<float>*, numModulationLFOs> modulationWaveforms {};
+        std::array<std::atomic<float>*, numRoutes> routeSources {}, routeTargets {}, routeDepths {};
     };
-    std::array<FilterState, 2> filterStates;
-    
-    // Helper methods
-    float generateLFO(LFOWaveform waveform, float phase);
-    void processFilter(float* buffer, int numSamples, int channel, 
-                      float frequency, float resonance, int filterType);
-    float getEffectiveRate(float rateParam, bool tempoSync);
+    ParameterHandles parameters;
+
+    // Plain copy of every parameter; the effect reads only this
+    Parameters readParameters() const noexcept;
+
+    // Factory programs, from the presets in the README
+    struct Program
+    {
+        const char* name;
+        Parameters parameters;
+    };
+    static const std::array<Program, 5> factoryPrograms;
+    int currentProgram = 0;
+
+    // Normalised values of every parameter as the last restored state set them, until a program
+    // is selected; see setCurrentProgram()
+    std::vector<float> restoredValues;
+    std::vector<float> getParameterValues() const;
+
+    // Versioned binary state: a header, then every parameter as its ID and real value.
+    // State saved as XML by earlier versions is still read.
+    static constexpr int stateMagic = 0x534b4c46; // "FLKS" in the little-endian byte order of the stream
+    static constexpr int stateVersion = 1;
+    bool readBinaryState(const void* data, int sizeInBytes);
+    void writeParameters(const Parameters& values);
+
+    // setStateInformation() and setCurrentProgram() write all the parameters between two increments
+    // of stateSequence, so it is odd while they are half written. The audio thread keeps using its
+    // last complete snapshot until the sequence is even again and unchanged across its read, and
+    // passes a new one to the effect as a program change.
+    std::atomic<std::uint32_t> stateSequence {0};
+    template <typename Function> void writeState(Function&& write);
+
+    // The DSP. Everything from here on is written by the audio thread only, so it starts on a
+    // fresh cache line, away from the parameter tree the message thread works on.
+    alignas(flarksiesis::cacheLineSize) flarksiesis::Effect effect;
+    std::uint32_t appliedStateSequence = 0;
+
+    flarksiesis::LoadMeter loadMeter;
+    ModulationTelemetry modulationTelemetry;
+
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer);
+    void updateParameters(flarksiesis::Effect& target) noexcept override;
+    double getHostTempo(); // Reads the playhead, so only from processBlock()
+    void timerCallback() override;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FlarksiesisAudioProcessor)
 };
@@ -0,0 +1,284 @@
+// The hooks below define open() and open64() (and the like) separately, so the headers must not
+// rename one to the other
+#undef _FILE_OFFSET_BITS
+
+#include "RealtimeGuard.h"
+
+#if FLARKSIESIS_REALTIME_CHECKS
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__) && defined(__GLIBC__)
+ #define FLARKSIESIS_HOOK_LIBC 1
+ #include <cstdarg>
+ #include <dlfcn.h>
+ #include <fcntl.h>
+ #include <pthread.h>
+ #include <sys/syscall.h>
+ #include <time.h>
+ #include <unistd.h>
+#endif
+
+#if defined(__GNUC__)
+ #define FLARKSIESIS_INITIAL_EXEC_TLS __attribute__((tls_model("initial-exec")))
+#else
+ #define FLARKSIESIS_INITIAL_EXEC_TLS
+#endif
+
+namespace flarksiesis
+{
+
+// initial-exec TLS so that reading it can never itself allocate
+static thread_local const char* currentScope FLARKSIESIS_INITIAL_EXEC_TLS = nullptr;
+
+static void writeToStderr(const char* text) noexcept
+{
+#if FLARKSIESIS_HOOK_LIBC
+    ::syscall(SYS_write, 2, text, std::strlen(text));
+#else
+    std::fputs(text, stderr);
+#endif
+}
+
+ScopedRealtimeGuard::ScopedRealtimeGuard(const char* scopeName) noexcept
+    : previousScope(currentScope)
+{
+    currentScope = scopeName;
+}
+
+ScopedRealtimeGuard::~ScopedRealtimeGuard() noexcept
+{
+    currentScope = previousScope;
+}
+
+void checkRealtimeAllowed(const char* operation) noexcept
+{
+    if (currentScope == nullptr)
+        return;
+
+    const char* scope = currentScope;
+    currentScope = nullptr; // Reporting may allocate or lock
+
+    writeToStderr("Flarksiesis real-time violation: ");
+    writeToStderr(operation);
+    writeToStderr(" inside ");
+    writeToStderr(scope);
+    writeToStderr("\n");
+    std::abort();
+}
+
+} // namespace flarksiesis
+
+//==============================================================================
+#if FLARKSIESIS_HOOK_LIBC
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void* __libc_valloc(size_t);
+    void* __libc_pvalloc(size_t);
+    void __libc_free(void*);
+
+    void* malloc(size_t size)
+    {
+        flarksiesis::checkRealtimeAllowed("malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size)
+    {
+        flarksiesis::checkRealtimeAllowed("calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* ptr, size_t size)
+    {
+        flarksiesis::checkRealtimeAllowed("realloc");
+        return __libc_realloc(ptr, size);
+    }
+
+    void free(void* ptr)
+    {
+        if (ptr != nullptr)
+            flarksiesis::checkRealtimeAllowed("free");
+
+        __libc_free(ptr);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size)
+    {
+        flarksiesis::checkRealtimeAllowed("posix_memalign");
+        *result = __libc_memalign(alignment, size);
+        return *result != nullptr || size == 0 ? 0 : 12; // ENOMEM
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size)
+    {
+        flarksiesis::checkRealtimeAllowed("aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    void* memalign(size_t alignment, size_t size)
+    {
+        flarksiesis::checkRealtimeAllowed("memalign");
+        return __libc_memalign(alignment, size);
+    }
+
+    void* valloc(size_t size)
+    {
+        flarksiesis::checkRealtimeAllowed("valloc");
+        return __libc_valloc(size);
+    }
+
+    void* pvalloc(size_t size)
+    {
+        flarksiesis::checkRealtimeAllowed("pvalloc");
+        return __libc_pvalloc(size);
+    }
+}
+
+// The remaining hooks forward to the next definition in the lookup order
+template <typename Function>
+static Function nextSymbol(Function& cache, const char* name) noexcept
+{
+    if (cache == nullptr)
+        cache = reinterpret_cast<Function>(::dlsym(RTLD_NEXT, name));
+
+    return cache;
+}
+
+#define FLARKSIESIS_FORWARD(name, ...) \
+    static decltype(&::name) next = nullptr; \
+    flarksiesis::checkRealtimeAllowed(#name); \
+    return nextSymbol(next, #name)(__VA_ARGS__);
+
+// open() and openat() only take a mode when they may create the file
+#ifdef O_TMPFILE
+ #define FLARKSIESIS_CREATE_FLAGS (O_CREAT | O_TMPFILE)
+#else
+ #define FLARKSIESIS_CREATE_FLAGS O_CREAT
+#endif
+
+#define FLARKSIESIS_OPEN_MODE(flags) \
+    mode_t mode = 0; \
+    if (((flags) & FLARKSIESIS_CREATE_FLAGS) != 0) \
+    { \
+        va_list arguments; \
+        va_start(arguments, flags); \
+        mode = static_cast<mode_t>(va_arg(arguments, int)); \
+        va_end(arguments); \
+    }
+
+extern "C"
+{
+    int pthread_mutex_lock(pthread_mutex_t* mutex)                          { FLARKSIESIS_FORWARD(pthread_mutex_lock, mutex) }
+    int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex)    { FLARKSIESIS_FORWARD(pthread_cond_wait, cond, mutex) }
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock)                       { FLARKSIESIS_FORWARD(pthread_rwlock_rdlock, lock) }
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock)                       { FLARKSIESIS_FORWARD(pthread_rwlock_wrlock, lock) }
+    ssize_t read(int fd, void* data, size_t size)                           { FLARKSIESIS_FORWARD(read, fd, data, size) }
+    ssize_t write(int fd, const void* data, size_t size)                    { FLARKSIESIS_FORWARD(write, fd, data, size) }
+    int close(int fd)                                                       { FLARKSIESIS_FORWARD(close, fd) }
+    int open(const char* path, int flags, ...)                              { FLARKSIESIS_OPEN_MODE(flags) FLARKSIESIS_FORWARD(open, path, flags, mode) }
+    int open64(const char* path, int flags, ...)                            { FLARKSIESIS_OPEN_MODE(flags) FLARKSIESIS_FORWARD(open64, path, flags, mode) }
+    int openat(int directory, const char* path, int flags, ...)             { FLARKSIESIS_OPEN_MODE(flags) FLARKSIESIS_FORWARD(openat, directory, path, flags, mode) }
+    int openat64(int directory, const char* path, int flags, ...)           { FLARKSIESIS_OPEN_MODE(flags) FLARKSIESIS_FORWARD(openat64, directory, path, flags, mode) }
+    FILE* fopen(const char* path, const char* mode)                         { FLARKSIESIS_FORWARD(fopen, path, mode) }
+    FILE* fopen64(const char* path, const char* mode)                       { FLARKSIESIS_FORWARD(fopen64, path, mode) }
+    int nanosleep(const timespec* duration, timespec* remaining)            { FLARKSIESIS_FORWARD(nanosleep, duration, remaining) }
+    int usleep(useconds_t microseconds)                                     { FLARKSIESIS_FORWARD(usleep, microseconds) }
+}
+
+#undef FLARKSIESIS_OPEN_MODE
+#undef FLARKSIESIS_CREATE_FLAGS
+#undef FLARKSIESIS_FORWARD
+#endif
+
+//==============================================================================
+static void* allocateAligned(std::size_t size, std::align_val_t alignment) noexcept
+{
+    const auto align = static_cast<std::size_t>(alignment);
+
+#if defined(_MSC_VER)
+    return _aligned_malloc(size == 0 ? align : size, align);
+#else
+    // Not std::aligned_alloc: libc++ only has it from macOS 10.15, and the deployment target is 10.14
+    void* ptr = nullptr;
+    return ::posix_memalign(&ptr, std::max(align, sizeof(void*)), size == 0 ? align : size) == 0 ? ptr : nullptr;
+#endif
+}
+
+static void freeAligned(void* ptr) noexcept
+{
+#if defined(_MSC_VER)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+void* operator new(std::size_t size)
+{
+    flarksiesis::checkRealtimeAllowed("operator new");
+
+    if (auto* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    flarksiesis::checkRealtimeAllowed("operator new[]");
+
+    if (auto* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    flarksiesis::checkRealtimeAllowed("operator new");
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    flarksiesis::checkRealtimeAllowed("operator new[]");
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    flarksiesis::checkRealtimeAllowed("operator new");
+
+    if (auto* ptr = allocateAligned(size, alignment))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    flarksiesis::checkRealtimeAllowed("operator new[]");
+
+    if (auto* ptr = allocateAligned(size, alignment))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept                        { if (ptr != nullptr) flarksiesis::checkRealtimeAllowed("operator delete"); std::free(ptr); }
+void operator delete[](void* ptr) noexcept                      { if (ptr != nullptr) flarksiesis::checkRealtimeAllowed("operator delete[]"); std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept           { operator delete(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept         { operator delete[](ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept      { if (ptr != nullptr) flarksiesis::checkRealtimeAllowed("operator delete"); freeAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept    { if (ptr != nullptr) flarksiesis::checkRealtimeAllowed("operator delete[]"); freeAligned(ptr); }
+
+#endif
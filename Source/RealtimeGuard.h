@@ -0,0 +1,45 @@
+#pragma once
+
+//==============================================================================
+/**
+    Real-time safety checks for the audio callback.
+
+    Configure with -DFLARKSIESIS_REALTIME_CHECKS=ON to make any heap allocation,
+    mutex lock, blocking file I/O or sleep performed inside a
+    FLARKSIESIS_REALTIME_SCOPE print what happened and abort the process.
+
+    operator new/delete are hooked on every platform. On Linux the malloc family
+    (memalign and valloc included), pthread locks and the common blocking system
+    calls (open, openat, fopen, read, write, close and the sleeps) are hooked as
+    well; those hooks interpose process-wide when the plugin code is linked into
+    an executable (Standalone, command line tools), but not inside a plugin that
+    a host loads with dlopen(). With the option off the scope macro compiles to
+    nothing.
+*/
+#if FLARKSIESIS_REALTIME_CHECKS
+
+namespace flarksiesis
+{
+
+class ScopedRealtimeGuard
+{
+public:
+    explicit ScopedRealtimeGuard(const char* scopeName) noexcept;
+    ~ScopedRealtimeGuard() noexcept;
+
+    ScopedRealtimeGuard(const ScopedRealtimeGuard&) = delete;
+    ScopedRealtimeGuard& operator=(const ScopedRealtimeGuard&) = delete;
+
+private:
+    const char* previousScope;
+};
+
+// Aborts with a message if the calling thread is inside a real-time scope
+void checkRealtimeAllowed(const char* operation) noexcept;
+
+} // namespace flarksiesis
+
+ #define FLARKSIESIS_REALTIME_SCOPE(scopeName) const flarksiesis::ScopedRealtimeGuard realtimeGuard (scopeName)
+#else
+ #define FLARKSIESIS_REALTIME_SCOPE(scopeName)
+#endif
@@ -0,0 +1,172 @@
+#include "DSP/CoefficientTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <vector>
+
+//==============================================================================
+/*
+    Checks CoefficientTable::lookup() against designBiquad() for every filter
+    type at 44.1, 48, 96 and 192 kHz. The cutoff is taken halfway between every
+    pair of neighbouring grid frequencies and the resonance halfway (in 1 /
+    resonance) between neighbouring grid resonances, plus both ends of the
+    range, which is where interpolation strays furthest. Each response is
+    compared over two octaves either side of the cutoff, closely around it.
+
+    Fails if the magnitude ever differs by more than the bounds documented in
+    CoefficientTable.h, measured wherever designBiquad()'s response is above
+    -20 dB, or if the allpass's phase does.
+*/
+namespace
+{
+
+using namespace flarksiesis;
+
+constexpr double maxErrorDb = 0.12;          // Every type but the notch
+constexpr double maxNotchErrorDb = 0.2;      // On the notch's skirts
+constexpr double maxAllpassErrorDegrees = 3.0;
+constexpr double floorDb = -20.0;
+constexpr int pointsPerOctave = 16;          // Where the responses are compared, and 8 times as
+constexpr int densePointsPerOctave = 128;    // many within a quarter octave of the cutoff, for the peaks
+const double sampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+const char* const filterTypeNames[] = { "lowpass", "highpass", "bandpass", "notch",
+                                        "allpass", "lowpass_12", "highpass_12", "bandpass_12" };
+
+// The delta-operator form's numerator and denominator at q = z - 1 (FilterCoefficients.h)
+std::complex<double> numerator(const BiquadCoefficients& c, std::complex<double> q)
+{
+    return (c.b0 * q + c.b1) * q + c.b2;
+}
+
+std::complex<double> denominator(const BiquadCoefficients& c, std::complex<double> q)
+{
+    return (q + c.a1) * q + c.a2;
+}
+
+// Where a cutoff's responses are compared, as q = z - 1: coarsely over two octaves either side
+// of it, closely within a quarter octave, and only below Nyquist
+std::vector<std::complex<double>> makePoints(float frequency, double sampleRate)
+{
+    constexpr double twoPi = 6.283185307179586;
+    std::vector<std::complex<double>> points;
+
+    for (int point = -2 * densePointsPerOctave; point <= 2 * densePointsPerOctave; ++point)
+    {
+        const bool isDense = std::abs(point) <= densePointsPerOctave / 4;
+
+        if (! isDense && point % (densePointsPerOctave / pointsPerOctave) != 0)
+            continue;
+
+        const double at = frequency * std::exp2(static_cast<double>(point) / densePointsPerOctave);
+
+        if (at >= 0.5 * sampleRate)
+            break;
+
+        points.push_back(std::polar(1.0, twoPi * at / sampleRate) - 1.0);
+    }
+
+    return points;
+}
+
+struct Sweep
+{
+    double worst = 0.0;
+    float worstFrequency = 0.0f, worstResonance = 0.0f;
+    double worstSampleRate = 0.0;
+
+    void check(const CoefficientTable& table, int filterType, float frequency, float resonance,
+               const std::vector<std::complex<double>>& points)
+    {
+        const double sampleRate = table.getSampleRate();
+        const auto looked = table.lookup(filterType, frequency, resonance);
+        const auto designed = designBiquad(filterType, frequency, resonance, sampleRate);
+        const double floorPower = std::pow(10.0, floorDb / 10.0);
+
+        for (const auto& q : points)
+        {
+            // actual / expected = (actualNumerator expectedDenominator) / (actualDenominator expectedNumerator)
+            const auto expectedNumerator = numerator(designed, q), expectedDenominator = denominator(designed, q);
+
+            if (std::norm(expectedNumerator) < floorPower * std::norm(expectedDenominator))
+                continue;
+
+            const auto above = numerator(looked, q) * expectedDenominator;
+            const auto below = denominator(looked, q) * expectedNumerator;
+
+            const double error = filterType == 4 ? std::abs(std::arg(above * std::conj(below))) * 180.0 / 3.141592653589793
+                                                 : std::abs(10.0 * std::log10(std::norm(above) / std::norm(below)));
+
+            // NaN counts as a failure too
+            if (! (error <= worst))
+            {
+                worst = std::isnan(error) ? HUGE_VAL : error;
+                worstFrequency = frequency;
+                worstResonance = resonance;
+                worstSampleRate = sampleRate;
+            }
+        }
+    }
+
+    bool report(const char* name, double limit, const char* unit) const
+    {
+        const bool passed = worst <= limit;
+        std::printf("%s %-12s worst %.4f %s at %.1f Hz, Q %.3f, %.0f Hz (limit %g)\n", passed ? "ok    " : "FAILED",
+                    name, worst, unit, static_cast<double>(worstFrequency), static_cast<double>(worstResonance),
+                    worstSampleRate, limit);
+        return passed;
+    }
+};
+
+} // namespace
+
+//==============================================================================
+int main()
+{
+    Sweep sweeps[CoefficientTable::numFilterTypes];
+
+    for (double sampleRate : sampleRates)
+    {
+        const CoefficientTable table(sampleRate);
+
+        // The grids as CoefficientTable lays them out
+        const double top = std::min(static_cast<double>(CoefficientTable::maxFrequency), 0.49 * sampleRate);
+        const double frequencyStep = std::log2(top / CoefficientTable::minFrequency) / (CoefficientTable::numFrequencyPoints - 1);
+        const double resonanceStep = std::log2(static_cast<double>(CoefficientTable::maxResonance) / CoefficientTable::minResonance)
+                                   / (CoefficientTable::numResonancePoints - 1);
+
+        float resonances[CoefficientTable::numResonancePoints + 1];
+        resonances[0] = CoefficientTable::minResonance;
+        resonances[CoefficientTable::numResonancePoints] = CoefficientTable::maxResonance;
+
+        for (int r = 1; r < CoefficientTable::numResonancePoints; ++r)
+        {
+            const double below = CoefficientTable::minResonance * std::exp2((r - 1) * resonanceStep);
+            const double above = CoefficientTable::minResonance * std::exp2(r * resonanceStep);
+            resonances[r] = static_cast<float>(2.0 / (1.0 / below + 1.0 / above));
+        }
+
+        for (int f = 0; f + 1 < CoefficientTable::numFrequencyPoints; ++f)
+        {
+            const auto frequency = static_cast<float>(CoefficientTable::minFrequency * std::exp2((f + 0.5) * frequencyStep));
+            const auto points = makePoints(frequency, sampleRate);
+
+            for (float resonance : resonances)
+                for (int type = 0; type < CoefficientTable::numFilterTypes; ++type)
+                    sweeps[type].check(table, type, frequency, resonance, points);
+        }
+    }
+
+    bool passed = true;
+
+    for (int type = 0; type < CoefficientTable::numFilterTypes; ++type)
+    {
+        if (type == 4)
+            passed &= sweeps[type].report(filterTypeNames[type], maxAllpassErrorDegrees, "degrees");
+        else
+            passed &= sweeps[type].report(filterTypeNames[type], type == 3 ? maxNotchErrorDb : maxErrorDb, "dB");
+    }
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,705 @@
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+#include "DSP/Effect.h"
+#include "DSP/Kernels.h"
+#include "DSP/ModulationMapper.h"
+#include "DSP/OutputStage.h"
+#include "../Common/ProcessorSetup.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <random>
+#include <thread>
+
+//==============================================================================
+/*
+    flarksiesis_bench: measures the cost of processBlock and of each DSP stage.
+
+    By default every dimension is swept on its own around a baseline (lowpass,
+    sine, 512-sample blocks, stereo, 48 kHz, no feedback, no oversampling);
+    --full runs the whole cross product. Results are written as JSON, one
+    object per case, so two runs can be diffed or plotted.
+
+    --instances N runs 1, 2, 4, ... N processors on as many threads at once,
+    the way a host spreads plugin instances over its worker threads. With no
+    state shared between instances, throughput should grow close to linearly
+    up to the number of physical cores.
+*/
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+volatile float sink = 0.0f; // Keeps results alive so the optimiser can't drop the work
+
+const char* const filterTypeNames[] = { "Lowpass", "Highpass", "Bandpass", "Notch",
+                                        "Allpass", "LP 12dB", "HP 12dB", "BP 12dB" };
+const char* const waveformNames[] = { "Sine", "Triangle", "Square", "Saw", "Random" };
+const int blockSizes[] = { 1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+const int channelCounts[] = { 1, 2, 6, 12, 16 }; // Mono, stereo, 5.1, 7.1.4, third-order ambisonics
+const double sampleRates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+const float feedbackAmounts[] = { 0.0f, 0.5f };
+const char* const oversamplingNames[] = { "Off", "2x", "4x" };
+const char* const filterEngineNames[] = { "Biquad", "SVF" };
+
+struct Case
+{
+    const char* sweep = "baseline";
+    int filterType = 0;
+    int waveform = 0;
+    int blockSize = 512;
+    int channels = 2;
+    double sampleRate = 48000.0;
+    float feedback = 0.0f;
+    int oversampling = 0;
+    int filterEngine = 0;
+    bool doublePrecision = false;
+};
+
+struct Options
+{
+    double secondsPerCase = 0.05;
+    bool full = false;
+    bool stages = true;
+    bool processBlock = true;
+    bool gui = false;
+    int instances = 0;
+    juce::File output;
+};
+
+// Runs 'body' (which handles 'itemsPerCall' items) until minSeconds have passed; returns ns per item
+double measure(double minSeconds, double itemsPerCall, const std::function<void()>& body)
+{
+    for (int i = 0; i < 3; ++i)
+        body(); // Warm up caches and branch predictors
+
+    long long calls = 0;
+    const auto start = Clock::now();
+    double elapsed = 0.0;
+
+    do
+    {
+        for (int i = 0; i < 16; ++i)
+            body();
+
+        calls += 16;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    while (elapsed < minSeconds);
+
+    return elapsed * 1.0e9 / (static_cast<double>(calls) * itemsPerCall);
+}
+
+//==============================================================================
+// ns per frame of processBlock() on a prepared processor, with buffers of SampleType
+template <typename SampleType>
+double measureProcessBlock(FlarksiesisAudioProcessor& processor, const Case& c, double secondsPerCase)
+{
+    juce::AudioBuffer<SampleType> buffer(c.channels, c.blockSize);
+    juce::AudioBuffer<SampleType> input(c.channels, c.blockSize);
+    juce::MidiBuffer midi;
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+
+    for (int channel = 0; channel < c.channels; ++channel)
+        for (int sample = 0; sample < c.blockSize; ++sample)
+            input.getWritePointer(channel)[sample] = static_cast<SampleType>(noise(random));
+
+    return measure(secondsPerCase, c.blockSize, [&]
+    {
+        for (int channel = 0; channel < c.channels; ++channel)
+            buffer.copyFrom(channel, 0, input, channel, 0, c.blockSize);
+
+        processor.processBlock(buffer, midi);
+        sink = sink + static_cast<float>(buffer.getReadPointer(0)[c.blockSize - 1]);
+    });
+}
+
+juce::String benchProcessBlock(FlarksiesisAudioProcessor& processor, const Case& c, double secondsPerCase)
+{
+    using flarksiesis::tools::setParameter;
+
+    setParameter(processor, "filtertype", filterTypeNames[c.filterType]);
+    setParameter(processor, "waveform", waveformNames[c.waveform]);
+    setParameter(processor, "feedback", juce::String(c.feedback));
+    setParameter(processor, "oversampling", oversamplingNames[c.oversampling]);
+    setParameter(processor, "filterengine", filterEngineNames[c.filterEngine]);
+    setParameter(processor, "rate", "2");
+    setParameter(processor, "depth", "0.8");
+    setParameter(processor, "resonance", "2");
+    setParameter(processor, "mix", "0.7");
+
+    processor.setProcessingPrecision(c.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                       : juce::AudioProcessor::singlePrecision);
+    processor.prepareToPlay(c.sampleRate, c.blockSize);
+
+    const double nsPerFrame = c.doublePrecision ? measureProcessBlock<double>(processor, c, secondsPerCase)
+                                                : measureProcessBlock<float>(processor, c, secondsPerCase);
+
+    processor.releaseResources();
+
+    return juce::String::formatted("    {\"sweep\": \"%s\", \"filter_type\": \"%s\", \"waveform\": \"%s\", \"block_size\": %d, "
+                                   "\"channels\": %d, \"sample_rate\": %.0f, \"feedback\": %.2f, \"oversampling\": \"%s\", "
+                                   "\"filter_engine\": \"%s\", \"precision\": \"%s\", \"ns_per_frame\": %.3f, \"ns_per_sample\": %.3f}",
+                                   c.sweep, filterTypeNames[c.filterType], waveformNames[c.waveform], c.blockSize,
+                                   c.channels, c.sampleRate, static_cast<double>(c.feedback), oversamplingNames[c.oversampling],
+                                   filterEngineNames[c.filterEngine], c.doublePrecision ? "double" : "float", nsPerFrame, nsPerFrame / c.channels);
+}
+
+std::vector<Case> makeCases(bool full)
+{
+    std::vector<Case> cases;
+
+    if (full)
+    {
+        // Sample rate outermost: coefficient tables are rebuilt when it changes
+        for (double rate : sampleRates)
+            for (int channels : channelCounts)
+                for (int blockSize : blockSizes)
+                    for (float feedback : feedbackAmounts)
+                        for (int type = 0; type < 8; ++type)
+                            for (int waveform = 0; waveform < 5; ++waveform)
+                            {
+                                Case c;
+                                c.sweep = "full";
+                                c.sampleRate = rate;
+                                c.channels = channels;
+                                c.blockSize = blockSize;
+                                c.feedback = feedback;
+                                c.filterType = type;
+                                c.waveform = waveform;
+                                cases.push_back(c);
+                            }
+
+        return cases;
+    }
+
+    for (int type = 0; type < 8; ++type)            { Case c; c.sweep = "filter_type";  c.filterType = type;        cases.push_back(c); }
+    for (int waveform = 0; waveform < 5; ++waveform) { Case c; c.sweep = "waveform";     c.waveform = waveform;      cases.push_back(c); }
+    for (int blockSize : blockSizes)                 { Case c; c.sweep = "block_size";   c.blockSize = blockSize;    cases.push_back(c); }
+    for (int channels : channelCounts)               { Case c; c.sweep = "channels";     c.channels = channels;      cases.push_back(c); }
+    for (float feedback : feedbackAmounts)           { Case c; c.sweep = "feedback";     c.feedback = feedback;      cases.push_back(c); }
+    for (int mode = 0; mode < 3; ++mode)             { Case c; c.sweep = "oversampling"; c.oversampling = mode;      cases.push_back(c); }
+    for (int engine = 0; engine < 2; ++engine)       { Case c; c.sweep = "filter_engine"; c.filterEngine = engine;   cases.push_back(c); }
+    for (bool isDouble : { false, true })            { Case c; c.sweep = "precision"; c.doublePrecision = isDouble;  cases.push_back(c); }
+    for (double rate : sampleRates)                  { Case c; c.sweep = "sample_rate";  c.sampleRate = rate;        cases.push_back(c); }
+
+    return cases;
+}
+
+//==============================================================================
+juce::String stageResult(const char* name, const char* unit, double ns)
+{
+    std::fprintf(stderr, "  %-28s %9.3f ns per %s\n", name, ns, unit);
+    return juce::String::formatted("    {\"stage\": \"%s\", \"unit\": \"%s\", \"ns\": %.3f}", name, unit, ns);
+}
+
+// Filter banks, oversampling and the output stage for one sample type; stage names get 'suffix'
+template <typename SampleType>
+void benchAudioStages(juce::StringArray& results, double seconds, const char* suffix, double sampleRate,
+                      int blockSize, const std::vector<float>& cutoffs, const flarksiesis::CoefficientTable& table)
+{
+    using namespace flarksiesis;
+
+    const int interval = CoefficientEngine::defaultControlInterval;
+    const int numPoints = blockSize / interval;
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // Biquad bank, stereo, new targets every control interval
+    BiquadBank<SampleType> bank;
+    bank.prepare(2, CoefficientEngine::maxControlInterval);
+    juce::AudioBuffer<SampleType> audio(2, blockSize);
+    for (int channel = 0; channel < 2; ++channel)
+        for (int sample = 0; sample < blockSize; ++sample)
+            audio.getWritePointer(channel)[sample] = static_cast<SampleType>(unit(random) - 0.5f);
+
+    results.add(stageResult((juce::String("biquad_bank_stereo") + suffix).toRawUTF8(), "frame", measure(seconds, blockSize, [&]
+    {
+        for (int start = 0, point = 0; start < blockSize; start += interval, ++point)
+        {
+            bank.setTarget(0, table.lookup(0, cutoffs[static_cast<size_t>(point)], 2.0f));
+            bank.setTarget(1, table.lookup(0, cutoffs[static_cast<size_t>(point + numPoints)], 2.0f));
+            bank.process(audio.getArrayOfWritePointers(), start, interval);
+        }
+        sink = sink + audio.getReadPointer(0)[blockSize - 1];
+    })));
+
+    // The same with the state-variable filter, which designs with one tan() per target
+    SvfBank<SampleType> svfBank;
+    svfBank.prepare(2, CoefficientEngine::maxControlInterval);
+
+    results.add(stageResult((juce::String("svf_bank_stereo") + suffix).toRawUTF8(), "frame", measure(seconds, blockSize, [&]
+    {
+        for (int start = 0, point = 0; start < blockSize; start += interval, ++point)
+        {
+            svfBank.setTarget(0, designSvf(0, cutoffs[static_cast<size_t>(point)], 2.0f, sampleRate));
+            svfBank.setTarget(1, designSvf(0, cutoffs[static_cast<size_t>(point + numPoints)], 2.0f, sampleRate));
+            svfBank.process(audio.getArrayOfWritePointers(), start, interval);
+        }
+        sink = sink + audio.getReadPointer(0)[blockSize - 1];
+    })));
+
+    // Both banks again on the kernel specialised for each response; the stages above run the generic one
+    const char* responseNames[] = { "lowpass", "highpass", "bandpass", "notch", "allpass" };
+
+    for (int type = 0; type < 5; ++type)
+    {
+        const auto kernelSuffix = juce::String("_") + responseNames[type] + suffix;
+
+        bank.reset();
+        bank.setFilterType(type);
+        results.add(stageResult(("biquad_bank_stereo" + kernelSuffix).toRawUTF8(), "frame", measure(seconds, blockSize, [&]
+        {
+            for (int start = 0, point = 0; start < blockSize; start += interval, ++point)
+            {
+                bank.setTarget(0, table.lookup(type, cutoffs[static_cast<size_t>(point)], 2.0f));
+                bank.setTarget(1, table.lookup(type, cutoffs[static_cast<size_t>(point + numPoints)], 2.0f));
+                bank.process(audio.getArrayOfWritePointers(), start, interval);
+            }
+            sink = sink + audio.getReadPointer(0)[blockSize - 1];
+        })));
+
+        svfBank.reset();
+        svfBank.setFilterType(type);
+        results.add(stageResult(("svf_bank_stereo" + kernelSuffix).toRawUTF8(), "frame", measure(seconds, blockSize, [&]
+        {
+            for (int start = 0, point = 0; start < blockSize; start += interval, ++point)
+            {
+                svfBank.setTarget(0, designSvf(type, cutoffs[static_cast<size_t>(point)], 2.0f, sampleRate));
+                svfBank.setTarget(1, designSvf(type, cutoffs[static_cast<size_t>(point + numPoints)], 2.0f, sampleRate));
+                svfBank.process(audio.getArrayOfWritePointers(), start, interval);
+            }
+            sink = sink + audio.getReadPointer(0)[blockSize - 1];
+        })));
+    }
+
+    // Oversampling round trip, stereo
+    Oversampler<SampleType> oversampler;
+    oversampler.prepare(2, blockSize);
+
+    for (int factor : { 2, 4 })
+    {
+        oversampler.setFactor(factor);
+        const auto name = "oversampling_" + juce::String(factor) + "x_round_trip" + suffix;
+        results.add(stageResult(name.toRawUTF8(), "frame", measure(seconds, blockSize, [&]
+        {
+            oversampler.processUp(audio.getArrayOfReadPointers(), 0, blockSize);
+            oversampler.processDown(audio.getArrayOfWritePointers(), 0, blockSize);
+            sink = sink + audio.getReadPointer(0)[blockSize - 1];
+        })));
+    }
+
+    // Feedback and dry/wet mix, one channel
+    std::vector<SampleType> wet(static_cast<size_t>(blockSize)), dry(static_cast<size_t>(blockSize));
+    std::vector<float> mix(static_cast<size_t>(blockSize), 0.7f), feedback(static_cast<size_t>(blockSize), 0.5f);
+    for (size_t i = 0; i < dry.size(); ++i)
+        dry[i] = static_cast<SampleType>(unit(random) - 0.5f);
+
+    results.add(stageResult((juce::String("output_feedback") + suffix).toRawUTF8(), "sample", measure(seconds, blockSize, [&]
+    {
+        std::copy(dry.begin(), dry.end(), wet.begin());
+        SampleType previous = 0;
+        OutputStage::applyFeedback(wet.data(), feedback.data(), blockSize, previous);
+        sink = sink + wet.back();
+    })));
+
+    results.add(stageResult((juce::String("output_mix") + suffix).toRawUTF8(), "sample", measure(seconds, blockSize, [&]
+    {
+        OutputStage::mixDryWet(wet.data(), dry.data(), mix.data(), blockSize);
+        sink = sink + wet.back();
+    })));
+
+}
+
+juce::StringArray benchStages(double seconds)
+{
+    using namespace flarksiesis;
+
+    juce::StringArray results;
+    const double sampleRate = 48000.0;
+    const int blockSize = 512;
+    const int interval = CoefficientEngine::defaultControlInterval;
+    const int numPoints = blockSize / interval;
+
+    std::mt19937 random(99);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // Coefficient design: the trig design against the shared table
+    std::vector<float> frequencies(256), resonances(256);
+    for (size_t i = 0; i < frequencies.size(); ++i)
+    {
+        frequencies[i] = 20.0f * std::pow(1000.0f, unit(random));
+        resonances[i] = 0.1f + 9.9f * unit(random);
+    }
+
+    results.add(stageResult("coefficient_design_trig", "design", measure(seconds, 256.0 * 8.0, [&]
+    {
+        for (int type = 0; type < 8; ++type)
+            for (size_t i = 0; i < frequencies.size(); ++i)
+                sink = sink + designBiquad(type, frequencies[i], resonances[i], sampleRate).b0;
+    })));
+
+    const auto table = CoefficientTable::getShared(sampleRate);
+
+    results.add(stageResult("coefficient_design_table", "design", measure(seconds, 256.0 * 8.0, [&]
+    {
+        for (int type = 0; type < 8; ++type)
+            for (size_t i = 0; i < frequencies.size(); ++i)
+                sink = sink + table->lookup(type, frequencies[i], resonances[i]).b0;
+    })));
+
+    results.add(stageResult("coefficient_design_svf", "design", measure(seconds, 256.0 * 8.0, [&]
+    {
+        for (int type = 0; type < 8; ++type)
+            for (size_t i = 0; i < frequencies.size(); ++i)
+                sink = sink + designSvf(type, frequencies[i], resonances[i], sampleRate).g;
+    })));
+
+    // LFO generation, stereo, at the default control interval and per sample
+    LFOGenerator lfo;
+    lfo.prepare(2, blockSize);
+    std::vector<float> offsets(static_cast<size_t>(blockSize), 0.25f);
+
+    for (int waveform = 0; waveform < 5; ++waveform)
+    {
+        const auto name = juce::String("lfo_render_") + juce::String(waveformNames[waveform]).toLowerCase();
+        results.add(stageResult(name.toRawUTF8(), "point", measure(seconds, 2.0 * blockSize, [&]
+        {
+            lfo.render(waveform, 2.0 / sampleRate, blockSize, 0, 1, offsets.data());
+            sink = sink + lfo.getValues(1)[blockSize - 1];
+        })));
+    }
+
+    // LFO value to cutoff
+    std::vector<float> lfoValues(static_cast<size_t>(blockSize)), depths(static_cast<size_t>(blockSize), 0.8f),
+                       bases(static_cast<size_t>(blockSize), 1000.0f), cutoffs(static_cast<size_t>(blockSize));
+    for (auto& value : lfoValues)
+        value = unit(random) * 2.0f - 1.0f;
+
+    results.add(stageResult("modulation_map", "value", measure(seconds, blockSize, [&]
+    {
+        ModulationMapper::mapToCutoff(lfoValues.data(), depths.data(), bases.data(), cutoffs.data(), blockSize);
+        sink = sink + cutoffs[static_cast<size_t>(blockSize - 1)];
+    })));
+
+    // Modulation matrix at the control rate: four LFOs, four routes over three targets, applied to
+    // the control points and the mix ramp. Compare with lfo_render_sine, the single LFO per sample.
+    LFOBank lfoBank;
+    lfoBank.prepare(blockSize);
+    ModulationMatrix matrix;
+    matrix.prepare(blockSize);
+    matrix.setRoute(0, 1, ModulationMatrix::cutoff, 0.5f);
+    matrix.setRoute(1, 2, ModulationMatrix::resonance, 0.3f);
+    matrix.setRoute(2, 3, ModulationMatrix::mix, 0.2f);
+    matrix.setRoute(3, 0, ModulationMatrix::cutoff, -0.25f);
+
+    const int bankWaveforms[] = { 0, 1, 4, 3 };
+    const double bankIncrements[] = { 2.0 / sampleRate, 0.5 / sampleRate, 3.0 / sampleRate, 0.13 / sampleRate };
+    std::vector<float> pointValues(static_cast<size_t>(numPoints), 1000.0f), mixRamp(static_cast<size_t>(blockSize), 0.5f);
+
+    results.add(stageResult("modulation_matrix", "frame", measure(seconds, blockSize, [&]
+    {
+        matrix.process(lfoBank, lfoBank.render(bankWaveforms, bankIncrements, blockSize, 0, interval));
+        ModulationMapper::scaleByOctaves(pointValues.data(), matrix.getOffsets(ModulationMatrix::cutoff),
+                                         ModulationMapper::octavesAtFullDepth, 20.0f, 20000.0f, numPoints);
+        ModulationMapper::scaleByOctaves(pointValues.data(), matrix.getOffsets(ModulationMatrix::resonance),
+                                         2.0f, 0.1f, 10.0f, numPoints);
+        matrix.applyToRamp(ModulationMatrix::mix, mixRamp.data(), blockSize, 0, interval, 1.0f, 0.0f, 1.0f);
+        sink = sink + pointValues.back() + mixRamp.back();
+    })));
+
+    // The stages that carry audio, in both sample types
+    benchAudioStages<float>(results, seconds, "", sampleRate, blockSize, cutoffs, *table);
+    benchAudioStages<double>(results, seconds, "_double", sampleRate, blockSize, cutoffs, *table);
+
+    // The DSP core on its own, without a processor around it: what a render engine pays to create
+    // one, against a whole processor with its parameter tree, and what it costs to run
+    results.add(stageResult("effect_instantiate", "instance", measure(seconds, 1.0, [&]
+    {
+        auto effect = std::make_unique<Effect>();
+        sink = sink + static_cast<float>(effect->getLatencySamples());
+    })));
+
+    results.add(stageResult("processor_instantiate", "instance", measure(seconds, 1.0, [&]
+    {
+        auto processor = std::make_unique<FlarksiesisAudioProcessor>();
+        sink = sink + static_cast<float>(processor->getLatencySamples());
+    })));
+
+    auto effect = std::make_unique<Effect>();
+    Effect::Parameters params;
+    params.depth = 0.8f;
+    effect->setParameters(params);
+    effect->prepare(sampleRate, 2, blockSize);
+
+    std::vector<float> left(static_cast<size_t>(blockSize)), right(static_cast<size_t>(blockSize));
+    float* const channels[] = { left.data(), right.data() };
+
+    results.add(stageResult("effect_process_stereo", "frame", measure(seconds, blockSize, [&]
+    {
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            left[i] = unit(random) - 0.5f;
+            right[i] = unit(random) - 0.5f;
+        }
+
+        effect->process(channels, 2, blockSize);
+        sink = sink + right.back();
+    })));
+
+    return results;
+}
+
+// Paint cost of the whole editor into an offscreen image: with its background cache warm, and as
+// while audio plays, with a timer tick's worth of new telemetry before each paint
+juce::StringArray benchEditor(double seconds)
+{
+    juce::StringArray results;
+    FlarksiesisAudioProcessor processor;
+    std::unique_ptr<juce::AudioProcessorEditor> editor(processor.createEditor());
+    editor->setSize(800, 600);
+
+    juce::Image image(juce::Image::RGB, 800, 600, true);
+
+    results.add(stageResult("gui_editor_paint_cached", "paint", measure(seconds, 1.0, [&]
+    {
+        juce::Graphics g(image);
+        editor->paintEntireComponent(g, true);
+    })));
+
+    LFOVisualizer* visualizer = nullptr;
+
+    for (int i = 0; i < editor->getNumChildComponents(); ++i)
+        if (auto* found = dynamic_cast<LFOVisualizer*>(editor->getChildComponent(i)))
+            visualizer = found;
+
+    if (visualizer != nullptr)
+    {
+        // The visualizer's timer runs at 30 Hz; frames arrive at telemetryRateHz
+        const int framesPerTick = juce::roundToInt(FlarksiesisAudioProcessor::telemetryRateHz / 30.0);
+        auto& telemetry = processor.getModulationTelemetry();
+        double phase = 0.0;
+
+        results.add(stageResult("gui_editor_paint_playing", "paint", measure(seconds, 1.0, [&]
+        {
+            for (int i = 0; i < framesPerTick; ++i)
+            {
+                FlarksiesisAudioProcessor::ModulationFrame frame;
+                phase += 0.05;
+                frame.lfo[0] = static_cast<float>(std::sin(phase));
+                frame.lfo[1] = static_cast<float>(std::sin(phase + 0.5));
+                frame.cutoff[0] = static_cast<float>(1000.0 * std::exp2(2.0 * std::sin(phase)));
+                telemetry.push(frame);
+            }
+
+            visualizer->timerCallback();
+            juce::Graphics g(image);
+            editor->paintEntireComponent(g, true);
+        })));
+    }
+
+    return results;
+}
+
+//==============================================================================
+// Baseline case (stereo, 512-sample blocks, 48 kHz) on numInstances processors, one thread each.
+// Returns the total number of frames processed per second.
+double runInstances(int numInstances, double seconds)
+{
+    const int blockSize = 512;
+    const int numChannels = 2;
+
+    std::vector<std::unique_ptr<FlarksiesisAudioProcessor>> processors;
+
+    for (int i = 0; i < numInstances; ++i)
+    {
+        auto processor = std::make_unique<FlarksiesisAudioProcessor>();
+        flarksiesis::tools::setChannelCount(*processor, numChannels);
+        flarksiesis::tools::setParameter(*processor, "depth", "0.8");
+        flarksiesis::tools::setParameter(*processor, "resonance", "2");
+        processor->prepareToPlay(48000.0, blockSize);
+        processors.push_back(std::move(processor));
+    }
+
+    std::atomic<bool> running { true };
+    std::atomic<int> started { 0 };
+    std::vector<long long> blocks(static_cast<size_t>(numInstances), 0);
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < numInstances; ++i)
+    {
+        threads.emplace_back([&, i]
+        {
+            auto& processor = *processors[static_cast<size_t>(i)];
+            juce::AudioBuffer<float> buffer(numChannels, blockSize);
+            juce::MidiBuffer midi;
+            std::mt19937 random(static_cast<unsigned>(1234 + i));
+            std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+            long long count = 0;
+
+            started.fetch_add(1);
+
+            while (started.load() < numInstances)
+                std::this_thread::yield();
+
+            while (running.load(std::memory_order_relaxed))
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                    for (int sample = 0; sample < blockSize; ++sample)
+                        buffer.getWritePointer(channel)[sample] = noise(random);
+
+                processor.processBlock(buffer, midi);
+                ++count;
+            }
+
+            blocks[static_cast<size_t>(i)] = count;
+        });
+    }
+
+    while (started.load() < numInstances)
+        std::this_thread::yield();
+
+    const auto start = Clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running.store(false);
+
+    for (auto& thread : threads)
+        thread.join();
+
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    long long total = 0;
+
+    for (auto count : blocks)
+        total += count;
+
+    return static_cast<double>(total) * blockSize / elapsed;
+}
+
+juce::StringArray benchInstances(int maxInstances, double seconds)
+{
+    juce::StringArray results;
+    double singleThroughput = 0.0;
+
+    std::fprintf(stderr, "instances (%u hardware threads):\n", std::thread::hardware_concurrency());
+
+    for (int instances = 1;; instances = juce::jmin(maxInstances, instances * 2))
+    {
+        const double throughput = runInstances(instances, seconds);
+
+        if (instances == 1)
+            singleThroughput = throughput;
+
+        const double scaling = singleThroughput > 0.0 ? throughput / singleThroughput : 0.0;
+        std::fprintf(stderr, "  %3d  %12.0f frames/s  %6.2fx\n", instances, throughput, scaling);
+        results.add(juce::String::formatted("    {\"instances\": %d, \"frames_per_second\": %.0f, \"scaling\": %.3f, "
+                                            "\"efficiency\": %.3f}",
+                                            instances, throughput, scaling, scaling / instances));
+
+        if (instances == maxInstances)
+            break;
+    }
+
+    return results;
+}
+
+bool parseArguments(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg(argv[i]);
+
+        if (arg == "--full")                          options.full = true;
+        else if (arg == "--no-stages")                options.stages = false;
+        else if (arg == "--stages-only")              options.processBlock = false;
+        else if (arg == "--gui")                      options.gui = true;
+        else if (arg == "--instances" && i + 1 < argc) options.instances = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        else if (arg == "--time" && i + 1 < argc)     options.secondsPerCase = juce::String(argv[++i]).getDoubleValue() / 1000.0;
+        else if (arg == "--out" && i + 1 < argc)      options.output = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else
+        {
+            std::puts("Usage: flarksiesis_bench [--full] [--no-stages | --stages-only] [--gui] [--instances <n>]\n"
+                      "                         [--time <ms per case>] [--out <file.json>]\n"
+                      "\n"
+                      "--gui adds the editor's paint cost to the stages.\n"
+                      "--instances runs up to n processors on n threads; each step lasts 20 times --time.\n"
+                      "Writes JSON to stdout (or --out) and progress to stderr.");
+            return false;
+        }
+    }
+
+    return options.secondsPerCase > 0.0;
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Options options;
+
+    if (! parseArguments(argc, argv, options))
+        return 1;
+
+    std::fprintf(stderr, "kernels: %s\n", flarksiesis::getKernels().name);
+
+    juce::StringArray processResults, stageResults;
+
+    if (options.processBlock)
+    {
+        // One instance per channel count, reused across cases like a host would
+        std::map<int, std::unique_ptr<FlarksiesisAudioProcessor>> processors;
+
+        for (int channels : channelCounts)
+        {
+            processors[channels] = std::make_unique<FlarksiesisAudioProcessor>();
+            flarksiesis::tools::setChannelCount(*processors[channels], channels);
+        }
+
+        const auto cases = makeCases(options.full);
+        int index = 0;
+
+        for (const auto& c : cases)
+        {
+            processResults.add(benchProcessBlock(*processors[c.channels], c, options.secondsPerCase));
+            std::fprintf(stderr, "\rprocessBlock %d/%d", ++index, static_cast<int>(cases.size()));
+        }
+
+        std::fputs("\n", stderr);
+    }
+
+    if (options.stages)
+    {
+        std::fputs("stages:\n", stderr);
+        stageResults = benchStages(options.secondsPerCase);
+    }
+
+    if (options.gui)
+        stageResults.addArray(benchEditor(options.secondsPerCase));
+
+    juce::StringArray instanceResults;
+
+    if (options.instances > 0)
+        instanceResults = benchInstances(options.instances, 20.0 * options.secondsPerCase);
+
+    // The kernel set getKernels() chose for this CPU, which every number above ran on
+    const char* simd = flarksiesis::getKernels().name;
+
+    const auto json = juce::String::formatted("{\n  \"version\": \"%s\",\n  \"simd\": \"%s\",\n  \"seconds_per_case\": %.3f,\n",
+                                              JucePlugin_VersionString, simd, options.secondsPerCase)
+                    + "  \"process_block\": [\n" + processResults.joinIntoString(",\n") + "\n  ],\n"
+                    + "  \"stages\": [\n" + stageResults.joinIntoString(",\n") + "\n  ],\n"
+                    + "  \"instances\": [\n" + instanceResults.joinIntoString(",\n") + "\n  ]\n}\n";
+
+    if (options.output != juce::File())
+        return options.output.replaceWithText(json) ? 0 : 1;
+
+    std::fputs(json.toRawUTF8(), stdout);
+    return 0;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "PluginProcessor.h"
+
+//==============================================================================
+// Helpers shared by the command line tools for configuring a processor without a host
+namespace flarksiesis::tools
+{
+
+/** Sets a parameter from its real (not normalised) value, or a choice name such as "4x" or "Saw". */
+inline bool setParameter(FlarksiesisAudioProcessor& processor, const juce::String& id, const juce::String& text)
+{
+    auto* parameter = processor.getAPVTS().getParameter(id);
+
+    if (parameter == nullptr)
+        return false;
+
+    const bool isNumber = text.trim().containsOnly("0123456789.-+eE") && text.trim().isNotEmpty();
+    const float normalised = isNumber ? parameter->convertTo0to1(text.getFloatValue())
+                                      : parameter->getValueForText(text);
+
+    parameter->setValueNotifyingHost(juce::jlimit(0.0f, 1.0f, normalised));
+    return true;
+}
+
+/** Parses "id=value" and applies it. */
+inline bool applyOverride(FlarksiesisAudioProcessor& processor, const juce::String& assignment)
+{
+    if (! assignment.containsChar('='))
+        return false;
+
+    return setParameter(processor, assignment.upToFirstOccurrenceOf("=", false, false).trim(),
+                        assignment.fromFirstOccurrenceOf("=", false, false).trim());
+}
+
+/** Uses the same number of input and output channels; false if the processor doesn't support it. */
+inline bool setChannelCount(FlarksiesisAudioProcessor& processor, int numChannels)
+{
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+    layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+    return processor.setBusesLayout(layout);
+}
+
+} // namespace flarksiesis::tools
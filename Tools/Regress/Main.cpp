@@ -0,0 +1,862 @@
+#include "PluginProcessor.h"
+#include "DSP/FilterCoefficients.h"
+#include "../Common/ProcessorSetup.h"
+#include "Summary.h"
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+//==============================================================================
+/*
+    flarksiesis_regress: golden-render regression checks for the DSP path.
+
+    Fixed test signals (an impulse, a log sine sweep and seeded noise) are
+    rendered through every filter type and waveform, and through the SVF,
+    oversampled and double-precision paths. --record writes a summary of each
+    render (segment levels and a hash, see Summary.h) to a file, committed as
+    Tools/Regress/Goldens.txt; --compare renders again and compares the levels
+    with it, within each case's tolerance, and fails a case that has no
+    summary. Every case is also rendered at several block sizes and
+    compared with the reference block size, to catch output that depends on
+    how the host splits the stream, and double-precision cases are compared
+    with the float path. The last checks cover sleeping on silence, a low
+    cutoff at a high sample rate, the SVF designs against the biquad designs,
+    the SVF under the fastest modulation the parameters allow, and a
+    structure change faded with an LFO routed to the mix.
+
+    Cases always run in the same order, each on a fresh processor.
+*/
+namespace
+{
+
+constexpr double sampleRate = 48000.0;
+constexpr int numChannels = 2;
+constexpr int signalLength = 24000;       // Half a second
+constexpr int referenceBlockSize = 512;
+constexpr int segmentLength = 500;        // Per level in the golden summaries: 48 per channel
+const int otherBlockSizes[] = { 1, 37, 4096 };
+
+const char* const filterTypeNames[] = { "Lowpass", "Highpass", "Bandpass", "Notch",
+                                        "Allpass", "LP 12dB", "HP 12dB", "BP 12dB" };
+const char* const waveformNames[] = { "Sine", "Triangle", "Square", "Saw", "Random" };
+const char* const oversamplingNames[] = { "Off", "2x", "4x" };
+const char* const filterEngineNames[] = { "Biquad", "SVF" };
+
+enum Signal { impulse, sweep, noise, numSignals };
+
+constexpr double bitExact = -999.0; // What maxDifferenceDb() reports for identical buffers
+const char* const signalNames[] = { "impulse", "sweep", "noise" };
+
+struct Case
+{
+    int filterType = 0;
+    int waveform = 0;
+    int oversampling = 0;
+    int filterEngine = 0;
+    bool doublePrecision = false;
+    Signal signal = impulse;
+
+    // Largest allowed change in any segment level against the golden summary, in dB. Platforms
+    // and compilers move the levels by float rounding, which measures under 0.0001 dB (the
+    // float path against the double path, or a -ffast-math build against a strict one); a
+    // 0.5% change to the cutoff, resonance or mix moves most cases by more than this.
+    double levelToleranceDb = 0.005;
+
+    // Largest allowed difference, in dB relative to full scale. Other block sizes must match
+    // bit for bit: the effect's parameter and control grids don't move with the blocks.
+    double blockToleranceDb = bitExact;
+    double precisionToleranceDb = -100.0; // Double path against the float path
+
+    juce::String getName() const
+    {
+        return juce::String(filterTypeNames[filterType]).replaceCharacter(' ', '_') + "_" + waveformNames[waveform]
+             + "_" + signalNames[signal] + (oversampling > 0 ? juce::String("_") + oversamplingNames[oversampling] : juce::String())
+             + (filterEngine > 0 ? juce::String("_") + filterEngineNames[filterEngine] : juce::String())
+             + (doublePrecision ? "_double" : "");
+    }
+};
+
+struct Options
+{
+    juce::File recordFile, compareFile;
+    bool checkBlockSizes = true;
+    double toleranceOffsetDb = 0.0;
+};
+
+//==============================================================================
+juce::AudioBuffer<float> makeSignal(Signal signal)
+{
+    juce::AudioBuffer<float> buffer(numChannels, signalLength);
+    buffer.clear();
+
+    switch (signal)
+    {
+        case impulse:
+            for (int channel = 0; channel < numChannels; ++channel)
+                buffer.setSample(channel, 0, 1.0f);
+            break;
+
+        case sweep:
+        {
+            // Log sweep from 20 Hz to 20 kHz, computed in double so it doesn't depend on float rounding
+            const double k = std::log(20000.0 / 20.0);
+            const double duration = signalLength / sampleRate;
+            const double pi = 3.14159265358979323846;
+
+            for (int sample = 0; sample < signalLength; ++sample)
+            {
+                const double t = sample / sampleRate;
+                const double phase = 2.0 * pi * 20.0 * duration / k * (std::exp(t / duration * k) - 1.0);
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    buffer.setSample(channel, sample, static_cast<float>(0.5 * std::sin(phase)));
+            }
+            break;
+        }
+
+        case noise:
+        default:
+        {
+            // std::mt19937 output is fixed by the standard; map it to floats by hand, not with a distribution
+            std::mt19937 random(0x5eed);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int sample = 0; sample < signalLength; ++sample)
+                    buffer.setSample(channel, sample, static_cast<float>(random() >> 8) * (1.0f / 16777216.0f) - 0.5f);
+            break;
+        }
+    }
+
+    return buffer;
+}
+
+// Runs the signal through a prepared processor in blocks of SampleType; the result is float either way
+template <typename SampleType>
+juce::AudioBuffer<float> renderBlocks(FlarksiesisAudioProcessor& processor, const juce::AudioBuffer<float>& input,
+                                      int blockSize)
+{
+    const int length = input.getNumSamples();
+    juce::AudioBuffer<float> output(numChannels, length);
+    juce::AudioBuffer<SampleType> block(numChannels, blockSize);
+    juce::MidiBuffer midi;
+
+    for (int start = 0; start < length; start += blockSize)
+    {
+        const int count = juce::jmin(blockSize, length - start);
+        block.setSize(numChannels, count, false, false, true);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int sample = 0; sample < count; ++sample)
+                block.setSample(channel, sample, static_cast<SampleType>(input.getSample(channel, start + sample)));
+
+        processor.processBlock(block, midi);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int sample = 0; sample < count; ++sample)
+                output.setSample(channel, start + sample, static_cast<float>(block.getSample(channel, sample)));
+    }
+
+    return output;
+}
+
+juce::AudioBuffer<float> render(const Case& c, const juce::AudioBuffer<float>& input, int blockSize)
+{
+    using flarksiesis::tools::setParameter;
+
+    FlarksiesisAudioProcessor processor;
+    flarksiesis::tools::setChannelCount(processor, numChannels);
+
+    setParameter(processor, "filtertype", filterTypeNames[c.filterType]);
+    setParameter(processor, "waveform", waveformNames[c.waveform]);
+    setParameter(processor, "oversampling", oversamplingNames[c.oversampling]);
+    setParameter(processor, "filterengine", filterEngineNames[c.filterEngine]);
+    setParameter(processor, "rate", "5");
+    setParameter(processor, "depth", "0.8");
+    setParameter(processor, "frequency", "1000");
+    setParameter(processor, "resonance", "2");
+    setParameter(processor, "mix", "0.8");
+    setParameter(processor, "stereowidth", "0.5");
+    setParameter(processor, "feedback", "0.3");
+
+    processor.setProcessingPrecision(c.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                       : juce::AudioProcessor::singlePrecision);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    auto output = c.doublePrecision ? renderBlocks<double>(processor, input, blockSize)
+                                    : renderBlocks<float>(processor, input, blockSize);
+
+    processor.releaseResources();
+    return output;
+}
+
+// Largest absolute difference in dBFS; bitExact when the buffers are identical
+double maxDifferenceDb(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+{
+    if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+        return 0.0;
+
+    float largest = 0.0f;
+
+    for (int channel = 0; channel < a.getNumChannels(); ++channel)
+        for (int sample = 0; sample < a.getNumSamples(); ++sample)
+        {
+            const float x = a.getSample(channel, sample), y = b.getSample(channel, sample);
+
+            if (std::isnan(x) != std::isnan(y))
+                return 0.0;
+
+            largest = std::max(largest, std::abs(x - y));
+        }
+
+    return largest > 0.0f ? 20.0 * std::log10(static_cast<double>(largest)) : bitExact;
+}
+
+//==============================================================================
+flarksiesis::regress::Summary summarise(const juce::AudioBuffer<float>& buffer)
+{
+    return flarksiesis::regress::summarise(buffer.getArrayOfReadPointers(), buffer.getNumChannels(),
+                                           buffer.getNumSamples(), segmentLength);
+}
+
+bool writeGoldens(const juce::File& file, const juce::StringArray& lines)
+{
+    return file.replaceWithText("# Golden summaries for flarksiesis_regress, one case per line: the name, a hash of\n"
+                                "# the render, then RMS levels in dBFS over segments of "
+                                + juce::String(segmentLength) + " samples, channel by channel.\n"
+                                "# Re-record with the flarksiesis_record_goldens target; see Tools/Regress/Summary.h.\n"
+                                + lines.joinIntoString("\n") + "\n");
+}
+
+bool readGoldens(const juce::File& file, std::map<std::string, flarksiesis::regress::Summary>& goldens)
+{
+    juce::StringArray lines;
+    file.readLines(lines);
+
+    for (const auto& line : lines)
+    {
+        std::string name;
+        flarksiesis::regress::Summary summary;
+
+        if (flarksiesis::regress::parseSummary(line.toStdString(), name, summary))
+            goldens[name] = summary;
+        else if (line.isNotEmpty() && ! line.startsWith("#"))
+            return false;
+    }
+
+    return true;
+}
+
+//==============================================================================
+/** Noise, three seconds of silence, then noise again: the processor must go to sleep during the
+    silence, output exact zeros while asleep, and process the first block of new input. */
+juce::String checkSleepOnSilence()
+{
+    const int burst = 12000, gap = 144000, blockSize = 512;
+    const auto noiseSignal = makeSignal(noise);
+
+    juce::AudioBuffer<float> input(numChannels, 2 * burst + gap);
+    input.clear();
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        input.copyFrom(channel, 0, noiseSignal, channel, 0, burst);
+        input.copyFrom(channel, burst + gap, noiseSignal, channel, 0, burst);
+    }
+
+    FlarksiesisAudioProcessor processor;
+    flarksiesis::tools::setChannelCount(processor, numChannels);
+    flarksiesis::tools::setParameter(processor, "resonance", "2");
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> block(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    float lateGapPeak = 0.0f, wakePeak = 0.0f;
+
+    for (int start = 0; start < input.getNumSamples(); start += blockSize)
+    {
+        const int count = juce::jmin(blockSize, input.getNumSamples() - start);
+        block.setSize(numChannels, count, false, false, true);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            block.copyFrom(channel, 0, input, channel, start, count);
+
+        processor.processBlock(block, midi);
+
+        // The last second of the gap must be exactly silent; the block holding the new input must not be
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            if (start >= burst + gap - 48000 && start + count <= burst + gap)
+                lateGapPeak = juce::jmax(lateGapPeak, block.getMagnitude(channel, 0, count));
+
+            if (start <= burst + gap && burst + gap < start + count)
+                wakePeak = juce::jmax(wakePeak, block.getMagnitude(channel, 0, count));
+        }
+    }
+
+    const auto skipped = processor.getNumSkippedBlocks();
+    processor.releaseResources();
+
+    if (skipped == 0)
+        return "no blocks were skipped";
+
+    if (lateGapPeak != 0.0f)
+        return juce::String::formatted("output during the silence peaks at %g", static_cast<double>(lateGapPeak));
+
+    if (wakePeak == 0.0f)
+        return "no output from the first block of new input";
+
+    std::printf("ok     sleep_on_silence (%llu blocks skipped)\n", static_cast<unsigned long long>(skipped));
+    return {};
+}
+
+//==============================================================================
+/** A 10 Hz sine through a 20 Hz lowpass at 192 kHz with 4x oversampling, where the filter runs at
+    768 kHz: the output must be finite and at the level of the analog response, for both lowpass
+    types and both sample types. Cutoffs this low against the rate are where a biquad's coefficients
+    lose their precision. */
+juce::String checkLowCutoffAtHighRate()
+{
+    constexpr double highRate = 192000.0, toneFrequency = 10.0, cutoff = 20.0, resonance = 0.707;
+    constexpr double amplitude = 0.5, toleranceDb = 0.1;
+    const int length = static_cast<int>(highRate), blockSize = 512;
+
+    // Second-order lowpass magnitude at the tone, which the bilinear transform keeps this far below Nyquist
+    const double ratio = toneFrequency / cutoff;
+    const double real = 1.0 - ratio * ratio, imaginary = ratio / resonance;
+    const double expectedDb = -10.0 * std::log10(real * real + imaginary * imaginary);
+
+    juce::AudioBuffer<float> input(numChannels, length);
+
+    for (int sample = 0; sample < length; ++sample)
+        for (int channel = 0; channel < numChannels; ++channel)
+            input.setSample(channel, sample, static_cast<float>(amplitude * std::sin(juce::MathConstants<double>::twoPi
+                                                                                      * toneFrequency * sample / highRate)));
+
+    juce::StringArray problems;
+
+    for (const char* filterType : { "Lowpass", "LP 12dB" })
+    {
+        for (bool doublePrecision : { false, true })
+        {
+            FlarksiesisAudioProcessor processor;
+            flarksiesis::tools::setChannelCount(processor, numChannels);
+            flarksiesis::tools::setParameter(processor, "filtertype", filterType);
+            flarksiesis::tools::setParameter(processor, "oversampling", "4x");
+            flarksiesis::tools::setParameter(processor, "frequency", juce::String(cutoff));
+            flarksiesis::tools::setParameter(processor, "resonance", juce::String(resonance));
+            flarksiesis::tools::setParameter(processor, "depth", "0");
+            flarksiesis::tools::setParameter(processor, "mix", "1");
+            flarksiesis::tools::setParameter(processor, "feedback", "0");
+
+            processor.setProcessingPrecision(doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                             : juce::AudioProcessor::singlePrecision);
+            processor.prepareToPlay(highRate, blockSize);
+
+            const auto output = doublePrecision ? renderBlocks<double>(processor, input, blockSize)
+                                                : renderBlocks<float>(processor, input, blockSize);
+
+            processor.releaseResources();
+
+            // The second half, once the filter has settled
+            float peak = 0.0f;
+            bool finite = true;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int sample = length / 2; sample < length; ++sample)
+                {
+                    const float value = output.getSample(channel, sample);
+                    finite = finite && std::isfinite(value);
+                    peak = juce::jmax(peak, std::abs(value));
+                }
+
+            const double levelDb = 20.0 * std::log10(static_cast<double>(peak) / amplitude);
+            const juce::String name = juce::String(filterType) + (doublePrecision ? " (double)" : "");
+
+            if (! finite)
+                problems.add(name + ": output isn't finite");
+            else if (std::abs(levelDb - expectedDb) > toleranceDb)
+                problems.add(name + juce::String::formatted(": tone at %.2f dB, expected %.2f", levelDb, expectedDb));
+        }
+    }
+
+    if (problems.isEmpty())
+        std::printf("ok     low_cutoff_at_high_rate\n");
+
+    return problems.joinIntoString("; ");
+}
+
+//==============================================================================
+/** designSvf() and designBiquad() must give the same response, for every filter type over the
+    cutoff and resonance ranges: the largest difference of their frequency responses, evaluated
+    in double, has to stay at the level of the SVF's float coefficients. */
+juce::String checkSvfMatchesBiquad()
+{
+    using Complex = std::complex<double>;
+    constexpr double toleranceDb = -90.0;
+    constexpr int numFrequencies = 1000;
+
+    // Biquads in delta-operator form, q = z - 1
+    auto biquadResponse = [](const flarksiesis::BiquadCoefficients& c, Complex z)
+    {
+        const Complex q = z - 1.0;
+        return (c.b0 * q * q + c.b1 * q + c.b2) / (q * q + c.a1 * q + c.a2);
+    };
+
+    // The SVF is the analog prototype through the bilinear transform, s = (z - 1) / (g (z + 1))
+    auto svfResponse = [](const flarksiesis::SvfCoefficients& c, Complex z)
+    {
+        const Complex s = (z - 1.0) / ((z + 1.0) * static_cast<double>(c.g));
+        const Complex denominator = s * s + static_cast<double>(c.k) * s + 1.0;
+        return static_cast<double>(c.m0) + (static_cast<double>(c.m1) * s + static_cast<double>(c.m2)) / denominator;
+    };
+
+    double worstDb = -400.0;
+    juce::String worstCase;
+
+    for (int type = 0; type < 8; ++type)
+        for (float cutoff : { 20.0f, 200.0f, 1000.0f, 5000.0f, 18000.0f })
+            for (float resonance : { 0.1f, 0.707f, 2.0f, 10.0f })
+            {
+                const auto biquad = flarksiesis::designBiquad(type, cutoff, resonance, sampleRate);
+                const auto svf = flarksiesis::designSvf(type, cutoff, resonance, sampleRate);
+                double difference = 0.0;
+
+                for (int i = 1; i < numFrequencies; ++i)
+                {
+                    const auto z = std::polar(1.0, juce::MathConstants<double>::pi * i / numFrequencies);
+                    difference = juce::jmax(difference, std::abs(biquadResponse(biquad, z) - svfResponse(svf, z)));
+                }
+
+                const double differenceDb = 20.0 * std::log10(juce::jmax(difference, 1.0e-20));
+
+                if (differenceDb > worstDb)
+                {
+                    worstDb = differenceDb;
+                    worstCase = juce::String::formatted("%s at %g Hz, Q %g", filterTypeNames[type],
+                                                        static_cast<double>(cutoff), static_cast<double>(resonance));
+                }
+            }
+
+    if (worstDb > toleranceDb)
+        return juce::String::formatted("responses differ by %.1f dB (limit %.1f) for ", worstDb, toleranceDb) + worstCase;
+
+    std::printf("ok     svf_matches_biquad (%.1f dB at worst)\n", worstDb);
+    return {};
+}
+
+//==============================================================================
+/** Noise through the SVF engine at the highest resonance, with the cutoff thrown across its range
+    by a 20 Hz square LFO at full depth and two more matrix LFOs, and a third on the resonance:
+    the coefficients jump as fast as the parameters can move them. The output must stay finite and
+    under the filter's resonant gain, for every filter type, with and without oversampling. */
+juce::String checkSvfFastSweep()
+{
+    constexpr float peakLimit = 10.0f; // The noise peaks at 0.5; Q = 10 gives at most 20 dB on top of full scale
+    const auto input = makeSignal(noise);
+
+    juce::StringArray problems;
+    float worstPeak = 0.0f;
+
+    for (int type = 0; type < 8; ++type)
+    {
+        for (const char* oversampling : { "Off", "4x" })
+        {
+            using flarksiesis::tools::setParameter;
+
+            FlarksiesisAudioProcessor processor;
+            flarksiesis::tools::setChannelCount(processor, numChannels);
+            setParameter(processor, "filtertype", filterTypeNames[type]);
+            setParameter(processor, "filterengine", "SVF");
+            setParameter(processor, "oversampling", oversampling);
+            setParameter(processor, "waveform", "Square");
+            setParameter(processor, "rate", "20");
+            setParameter(processor, "depth", "1");
+            setParameter(processor, "frequency", "2000");
+            setParameter(processor, "resonance", "10");
+            setParameter(processor, "mix", "1");
+            setParameter(processor, "feedback", "0");
+
+            const char* const sources[] = { "LFO 2", "LFO 3", "LFO 4" };
+            const char* const targets[] = { "Cutoff", "Cutoff", "Resonance" };
+            const char* const depths[] = { "1", "-1", "1" };
+            const char* const waveforms[] = { "Saw", "Square", "Random" };
+            const char* const rates[] = { "20", "19", "17" };
+
+            for (int i = 0; i < 3; ++i)
+            {
+                const auto lfo = "lfo" + juce::String(i + 2), route = "mod" + juce::String(i + 1);
+                setParameter(processor, lfo + "waveform", waveforms[i]);
+                setParameter(processor, lfo + "rate", rates[i]);
+                setParameter(processor, route + "source", sources[i]);
+                setParameter(processor, route + "target", targets[i]);
+                setParameter(processor, route + "depth", depths[i]);
+            }
+
+            processor.prepareToPlay(sampleRate, referenceBlockSize);
+            const auto output = renderBlocks<float>(processor, input, referenceBlockSize);
+            processor.releaseResources();
+
+            float peak = 0.0f;
+            bool finite = true;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int sample = 0; sample < output.getNumSamples(); ++sample)
+                {
+                    const float value = output.getSample(channel, sample);
+                    finite = finite && std::isfinite(value);
+                    peak = juce::jmax(peak, std::abs(value));
+                }
+
+            const juce::String name = juce::String(filterTypeNames[type]) + " (" + oversampling + ")";
+            worstPeak = juce::jmax(worstPeak, peak);
+
+            if (! finite)
+                problems.add(name + ": output isn't finite");
+            else if (peak > peakLimit)
+                problems.add(name + juce::String::formatted(": peaks at %g (limit %g)", static_cast<double>(peak),
+                                                            static_cast<double>(peakLimit)));
+        }
+    }
+
+    if (problems.isEmpty())
+        std::printf("ok     svf_fast_sweep (peak %.2f)\n", static_cast<double>(worstPeak));
+
+    return problems.joinIntoString("; ");
+}
+
+//==============================================================================
+/** A program change of filter type while an LFO is routed to the mix, through the effect itself:
+    the wet signal must fade out under the routes too, so the filter reset at the bottom of the
+    fade is inaudible. A click shows as a jump in the second difference of the output, which for
+    a 220 Hz tone stays near its level before and after the switch. */
+juce::String checkStructureFadeWithMixRoute()
+{
+    constexpr int blockSize = 512, length = 48000, switchBlock = 47, window = 2880;
+    constexpr double allowedRatio = 2.0;
+
+    flarksiesis::Effect::Parameters params;
+    params.filterType = 2;
+    params.frequency = 600.0f;
+    params.resonance = 8.0f;
+    params.depth = 0.5f;
+    params.mix = 0.5f;
+    params.routes[0] = { 1, flarksiesis::ModulationMatrix::mix, 1.0f };
+
+    auto effect = std::make_unique<flarksiesis::Effect>();
+    effect->setParameters(params);
+    effect->prepare(sampleRate, 1, blockSize);
+
+    std::vector<float> output(static_cast<size_t>(length));
+
+    for (int sample = 0; sample < length; ++sample)
+        output[static_cast<size_t>(sample)] = static_cast<float>(0.5 * std::sin(juce::MathConstants<double>::twoPi * 220.0 * sample / sampleRate));
+
+    for (int start = 0; start < length; start += blockSize)
+    {
+        if (start == switchBlock * blockSize)
+        {
+            params.filterType = 1;
+            effect->changeProgram(params);
+        }
+
+        float* channels[] = { output.data() + start };
+        effect->process(channels, 1, juce::jmin(blockSize, length - start));
+    }
+
+    auto largestSecondDifference = [&output](int from, int to)
+    {
+        float largest = 0.0f;
+
+        for (auto i = static_cast<size_t>(from); i < static_cast<size_t>(to); ++i)
+            largest = juce::jmax(largest, std::abs(output[i] - 2.0f * output[i - 1] + output[i - 2]));
+
+        return static_cast<double>(largest);
+    };
+
+    const int switchSample = switchBlock * blockSize;
+    const double steady = juce::jmax(largestSecondDifference(switchSample - window, switchSample),
+                                     largestSecondDifference(switchSample + 4 * window, switchSample + 5 * window));
+    const double across = largestSecondDifference(switchSample, switchSample + window);
+
+    if (across > allowedRatio * steady)
+        return juce::String::formatted("second difference reaches %.5f across the switch, %.5f in steady state", across, steady);
+
+    std::printf("ok     structure_fade_with_mix_route\n");
+    return {};
+}
+
+//==============================================================================
+std::vector<Case> makeCases()
+{
+    std::vector<Case> cases;
+
+    // Every filter type and waveform, for every signal
+    for (int type = 0; type < 8; ++type)
+        for (int waveform = 0; waveform < 5; ++waveform)
+            for (int signal = 0; signal < numSignals; ++signal)
+            {
+                Case c;
+                c.filterType = type;
+                c.waveform = waveform;
+                c.signal = static_cast<Signal>(signal);
+
+                // The impulse's tail decays into silence, and the effect goes to sleep at the end of
+                // the call in which it has stayed under the -100 dBFS threshold long enough; the
+                // blocks decide which call that is, but what is cut off is already under it. The
+                // impulse response's energy is nearly all in the first segment, where a change to
+                // the filter moves the level least, so its levels are held tighter: they sit well
+                // clear of rounding there, and at the -90 dBFS floor after it
+                if (c.signal == impulse)
+                {
+                    c.blockToleranceDb = -100.0;
+                    c.levelToleranceDb = 0.002;
+                }
+
+                cases.push_back(c);
+            }
+
+    // The oversampled path, once per filter type
+    for (int mode = 1; mode < 3; ++mode)
+        for (int type = 0; type < 8; ++type)
+        {
+            Case c;
+            c.filterType = type;
+            c.oversampling = mode;
+            c.signal = noise;
+            cases.push_back(c);
+        }
+
+    // The state-variable filter engine, once per filter type
+    for (int type = 0; type < 8; ++type)
+    {
+        Case c;
+        c.filterType = type;
+        c.filterEngine = 1;
+        c.signal = noise;
+        cases.push_back(c);
+    }
+
+    // The double-precision path, once per filter type and engine, and once oversampled
+    for (int engine = 0; engine < 2; ++engine)
+        for (int type = 0; type < 8; ++type)
+        {
+            Case c;
+            c.filterType = type;
+            c.filterEngine = engine;
+            c.doublePrecision = true;
+            c.signal = noise;
+            cases.push_back(c);
+        }
+
+    // At 4x the cutoff is low for the rate and the poles sit close to 1, where a direct-form
+    // biquad in float loses precision; the delta form keeps the float path as close here
+    {
+        Case c;
+        c.oversampling = 2;
+        c.doublePrecision = true;
+        c.signal = noise;
+        cases.push_back(c);
+    }
+
+    return cases;
+}
+
+bool parseArguments(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--record" && hasValue)              options.recordFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else if (arg == "--compare" && hasValue)        options.compareFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else if (arg == "--tolerance-offset" && hasValue) options.toleranceOffsetDb = juce::String(argv[++i]).getDoubleValue();
+        else if (arg == "--no-block-check")             options.checkBlockSizes = false;
+        else
+            return false;
+    }
+
+    return true;
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Options options;
+
+    if (! parseArguments(argc, argv, options))
+    {
+        std::puts("Usage: flarksiesis_regress [--record <file> | --compare <file>] [--no-block-check]\n"
+                  "                           [--tolerance-offset <dB>]\n"
+                  "\n"
+                  "  --record <file>          Write the golden summaries of every case to file\n"
+                  "  --compare <file>         Compare renders against the golden summaries in file\n"
+                  "  --no-block-check         Skip the block size independence check\n"
+                  "  --tolerance-offset <dB>  Added to the block size and precision tolerances\n"
+                  "                           (dBFS), e.g. -20 to tighten\n"
+                  "\n"
+                  "With neither --record nor --compare, only the block size check runs.\n"
+                  "Exits with 2 if any case fails, and with 1 if the --compare file can't be read.");
+        return 1;
+    }
+
+    const bool recording = options.recordFile != juce::File();
+    const bool comparing = options.compareFile != juce::File();
+    std::map<std::string, flarksiesis::regress::Summary> goldens;
+    juce::StringArray recordedLines;
+
+    // The goldens are committed, so a missing or damaged file is an error, not a skip
+    if (comparing && ! (options.compareFile.existsAsFile() && readGoldens(options.compareFile, goldens)))
+    {
+        std::fprintf(stderr, "Can't read golden summaries from %s\n", options.compareFile.getFullPathName().toRawUTF8());
+        return 1;
+    }
+
+    std::array<juce::AudioBuffer<float>, numSignals> signals;
+    for (int signal = 0; signal < numSignals; ++signal)
+        signals[static_cast<size_t>(signal)] = makeSignal(static_cast<Signal>(signal));
+
+    int failures = 0, exact = 0, compared = 0;
+    const auto cases = makeCases();
+
+    for (const auto& c : cases)
+    {
+        const auto name = c.getName();
+        const auto& input = signals[static_cast<size_t>(c.signal)];
+        const auto reference = render(c, input, referenceBlockSize);
+        const auto summary = summarise(reference);
+        juce::StringArray problems;
+
+        if (recording)
+            recordedLines.add(flarksiesis::regress::formatSummary(name.toStdString(), summary));
+
+        if (comparing)
+        {
+            const auto golden = goldens.find(name.toStdString());
+
+            if (golden == goldens.end())
+            {
+                // A new case needs its summary recorded and reviewed like any other change
+                problems.add("no golden summary: re-record the goldens");
+            }
+            else
+            {
+                const double difference = flarksiesis::regress::maxLevelDifferenceDb(summary, golden->second);
+                ++compared;
+                goldens.erase(golden);
+
+                if (summary.hash == golden->second.hash)
+                    ++exact;
+
+                if (difference > c.levelToleranceDb)
+                    problems.add(juce::String::formatted("levels differ from the golden by %.4f dB (limit %.4f)",
+                                                         difference, c.levelToleranceDb));
+            }
+        }
+
+        // The double path must sound like the float path, give or take float rounding
+        if (c.doublePrecision)
+        {
+            auto floatCase = c;
+            floatCase.doublePrecision = false;
+            const double difference = maxDifferenceDb(render(floatCase, input, referenceBlockSize), reference);
+
+            if (difference > c.precisionToleranceDb + options.toleranceOffsetDb)
+                problems.add(juce::String::formatted("differs from the float path by %.1f dB (limit %.1f)", difference,
+                                                     c.precisionToleranceDb + options.toleranceOffsetDb));
+        }
+
+        if (options.checkBlockSizes)
+        {
+            for (int blockSize : otherBlockSizes)
+            {
+                const double difference = maxDifferenceDb(render(c, input, blockSize), reference);
+
+                if (difference > c.blockToleranceDb + options.toleranceOffsetDb)
+                    problems.add(juce::String::formatted("block size %d differs by %.1f dB (limit %.1f)", blockSize,
+                                                         difference, c.blockToleranceDb + options.toleranceOffsetDb));
+            }
+        }
+
+        if (problems.isEmpty())
+        {
+            std::printf("ok     %s\n", name.toRawUTF8());
+        }
+        else
+        {
+            ++failures;
+            std::printf("FAILED %s: %s\n", name.toRawUTF8(), problems.joinIntoString("; ").toRawUTF8());
+        }
+    }
+
+    const auto sleepProblem = checkSleepOnSilence();
+
+    if (sleepProblem.isNotEmpty())
+    {
+        ++failures;
+        std::printf("FAILED sleep_on_silence: %s\n", sleepProblem.toRawUTF8());
+    }
+
+    const auto lowCutoffProblem = checkLowCutoffAtHighRate();
+
+    if (lowCutoffProblem.isNotEmpty())
+    {
+        ++failures;
+        std::printf("FAILED low_cutoff_at_high_rate: %s\n", lowCutoffProblem.toRawUTF8());
+    }
+
+    const auto svfDesignProblem = checkSvfMatchesBiquad();
+
+    if (svfDesignProblem.isNotEmpty())
+    {
+        ++failures;
+        std::printf("FAILED svf_matches_biquad: %s\n", svfDesignProblem.toRawUTF8());
+    }
+
+    const auto svfSweepProblem = checkSvfFastSweep();
+
+    if (svfSweepProblem.isNotEmpty())
+    {
+        ++failures;
+        std::printf("FAILED svf_fast_sweep: %s\n", svfSweepProblem.toRawUTF8());
+    }
+
+    const auto structureFadeProblem = checkStructureFadeWithMixRoute();
+
+    if (structureFadeProblem.isNotEmpty())
+    {
+        ++failures;
+        std::printf("FAILED structure_fade_with_mix_route: %s\n", structureFadeProblem.toRawUTF8());
+    }
+
+    if (recording && ! writeGoldens(options.recordFile, recordedLines))
+    {
+        std::fprintf(stderr, "Can't write %s\n", options.recordFile.getFullPathName().toRawUTF8());
+        return 1;
+    }
+
+    // Whatever is left was recorded for a case that no longer exists
+    for (const auto& golden : goldens)
+        std::printf("note   %s has a golden summary but no case: re-record to drop it\n", golden.first.c_str());
+
+    const int numChecks = static_cast<int>(cases.size()) + 5;
+    std::printf("\n%d of %d cases passed", numChecks - failures, numChecks);
+
+    // The hashes only match on the platform and compiler the goldens were recorded with
+    if (comparing)
+        std::printf(", %d of %d bit-exact with the goldens", exact, compared);
+
+    std::puts("");
+    return failures == 0 ? 0 : 2;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//==============================================================================
+/*
+    Golden summaries for flarksiesis_regress.
+
+    A render is summarised by the RMS level of each channel over consecutive
+    segments, in dBFS, and by a hash of its samples. The levels are what the
+    regression check compares: they follow any change to the sound (a filter
+    response, the LFO's shape or phase, the mix), yet differ between platforms
+    and compilers only by float rounding, so one committed file serves every
+    CI runner. The hash only says whether a render is bit for bit the one that
+    was recorded, which holds on the recording platform alone.
+
+    One line per case: the name, the hash in hex, then the levels, channel by
+    channel. Lines starting with # are comments.
+*/
+namespace flarksiesis::regress
+{
+
+/** Levels are clamped to this: below it, rounding is a large share of what's left. */
+constexpr double levelFloorDb = -90.0;
+
+struct Summary
+{
+    std::uint64_t hash = 0;
+    std::vector<double> levelsDb; // Channel by channel, segment by segment
+};
+
+/** Summarises numChannels channels of numSamples samples, in segments of segmentLength. */
+inline Summary summarise(const float* const* channels, int numChannels, int numSamples, int segmentLength)
+{
+    Summary summary;
+    summary.hash = 14695981039346656037ull; // FNV-1a over the bits of every sample
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        for (int start = 0; start < numSamples; start += segmentLength)
+        {
+            const int end = std::min(numSamples, start + segmentLength);
+            double sumOfSquares = 0.0;
+
+            for (int sample = start; sample < end; ++sample)
+            {
+                const float value = channels[channel][sample];
+                std::uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+
+                for (int byte = 0; byte < 4; ++byte)
+                    summary.hash = (summary.hash ^ ((bits >> (8 * byte)) & 0xffu)) * 1099511628211ull;
+
+                sumOfSquares += static_cast<double>(value) * value;
+            }
+
+            const double meanSquare = sumOfSquares / (end - start);
+
+            // NaN stays NaN, so it never matches a recorded level
+            if (std::isnan(meanSquare))
+                summary.levelsDb.push_back(meanSquare);
+            else
+                summary.levelsDb.push_back(meanSquare > 0.0 ? std::max(levelFloorDb, 10.0 * std::log10(meanSquare))
+                                                            : levelFloorDb);
+        }
+    }
+
+    return summary;
+}
+
+/** Largest difference between the levels of two summaries, in dB; infinity if they don't line up. */
+inline double maxLevelDifferenceDb(const Summary& a, const Summary& b)
+{
+    if (a.levelsDb.size() != b.levelsDb.size())
+        return INFINITY;
+
+    double largest = 0.0;
+
+    for (size_t i = 0; i < a.levelsDb.size(); ++i)
+    {
+        const double difference = std::abs(a.levelsDb[i] - b.levelsDb[i]);
+
+        if (std::isnan(difference))
+            return INFINITY;
+
+        largest = std::max(largest, difference);
+    }
+
+    return largest;
+}
+
+//==============================================================================
+/** The line recorded for a case; levels to 0.001 dB, well under any tolerance. */
+inline std::string formatSummary(const std::string& name, const Summary& summary)
+{
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(summary.hash));
+
+    std::string line = name + " " + hash;
+
+    for (double level : summary.levelsDb)
+    {
+        char text[16];
+        std::snprintf(text, sizeof(text), " %.3f", level);
+        line += text;
+    }
+
+    return line;
+}
+
+/** Parses a line written by formatSummary(); false for comments, blank lines and garbage. */
+inline bool parseSummary(const std::string& line, std::string& name, Summary& summary)
+{
+    if (line.empty() || line[0] == '#')
+        return false;
+
+    std::istringstream stream(line);
+    std::string hash;
+
+    if (! (stream >> name >> hash) || hash.size() != 16)
+        return false;
+
+    summary.hash = std::strtoull(hash.c_str(), nullptr, 16);
+    summary.levelsDb.clear();
+
+    for (double level; stream >> level;)
+        summary.levelsDb.push_back(level);
+
+    return stream.eof() && ! summary.levelsDb.empty();
+}
+
+} // namespace flarksiesis::regress
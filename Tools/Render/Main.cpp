@@ -0,0 +1,392 @@
+#include "PluginProcessor.h"
+#include "../Common/ProcessorSetup.h"
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+//==============================================================================
+/*
+    flarksiesis_render: runs audio files through FlarksiesisAudioProcessor offline.
+
+    Files are shared out to a pool of worker threads, each owning one processor,
+    and rendered as fast as the CPU allows. No audio device or editor is used.
+*/
+namespace
+{
+
+struct Options
+{
+    juce::MemoryBlock state;
+    juce::StringArray overrides;
+    juce::File outputDirectory;
+    juce::String suffix = "_flarksiesis";
+    juce::File saveStateFile;
+    int blockSize = 512;
+    int numJobs = 0;
+    juce::Array<juce::File> inputs;
+};
+
+struct FileResult
+{
+    bool ok = false;
+    juce::String message;
+    juce::int64 frames = 0;
+    int channels = 0;
+    double processSeconds = 0.0;
+    flarksiesis::LoadMeter::Statistics load;
+};
+
+void printUsage()
+{
+    std::puts("Usage: flarksiesis_render [options] <input files...>\n"
+              "\n"
+              "  --state <file>       Plugin state, as saved by a host (getStateInformation)\n"
+              "  --param <id=value>   Parameter override in real units or by choice name,\n"
+              "                       e.g. frequency=800, filtertype=Notch; may be repeated\n"
+              "  --save-state <file>  Write the resulting state blob and exit if no inputs are given\n"
+              "  --out <dir>          Output directory (default: next to each input)\n"
+              "  --suffix <text>      Appended to output file names (default: _flarksiesis)\n"
+              "  --block <samples>    Processing block size (default: 512)\n"
+              "  --jobs <n>           Worker threads (default: one per hardware thread)\n"
+              "\n"
+              "Outputs are WAV files with the input's length, channels and bit depth; the\n"
+              "plugin's latency is compensated. Nothing is rendered if two inputs would have\n"
+              "the same output file, or an output would overwrite an input.");
+}
+
+bool parseArguments(int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--help" || arg == "-h")
+            return false;
+
+        if (arg.startsWith("--") && ! hasValue)
+        {
+            std::fprintf(stderr, "Missing value for %s\n", arg.toRawUTF8());
+            return false;
+        }
+
+        if (arg == "--state")
+        {
+            const juce::File file = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+
+            if (! file.loadFileAsData(options.state))
+            {
+                std::fprintf(stderr, "Can't read state file %s\n", file.getFullPathName().toRawUTF8());
+                return false;
+            }
+        }
+        else if (arg == "--param")         options.overrides.add(argv[++i]);
+        else if (arg == "--save-state")    options.saveStateFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else if (arg == "--out")           options.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+        else if (arg == "--suffix")        options.suffix = argv[++i];
+        else if (arg == "--block")         options.blockSize = juce::String(argv[++i]).getIntValue();
+        else if (arg == "--jobs")          options.numJobs = juce::String(argv[++i]).getIntValue();
+        else if (arg.startsWith("--"))
+        {
+            std::fprintf(stderr, "Unknown option %s\n", arg.toRawUTF8());
+            return false;
+        }
+        else
+        {
+            options.inputs.add(juce::File::getCurrentWorkingDirectory().getChildFile(arg));
+        }
+    }
+
+    if (options.blockSize < 1 || options.blockSize > 65536)
+    {
+        std::fputs("--block must be between 1 and 65536\n", stderr);
+        return false;
+    }
+
+    return true;
+}
+
+bool configure(FlarksiesisAudioProcessor& processor, const Options& options, juce::String& error)
+{
+    if (! options.state.isEmpty())
+        processor.setStateInformation(options.state.getData(), static_cast<int>(options.state.getSize()));
+
+    for (const auto& assignment : options.overrides)
+    {
+        if (! flarksiesis::tools::applyOverride(processor, assignment))
+        {
+            error = "Unknown parameter in --param " + assignment;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+juce::File getOutputFile(const juce::File& input, const Options& options)
+{
+    const auto directory = options.outputDirectory == juce::File() ? input.getParentDirectory() : options.outputDirectory;
+    return directory.getChildFile(input.getFileNameWithoutExtension() + options.suffix + ".wav");
+}
+
+// Run before any worker starts: workers delete and rewrite their outputs, so two inputs with the
+// same output name (a.wav and a.flac, or the same name in two folders with --out) would write one
+// file at once, and an output named like an input (--suffix "" on a WAV) would delete that input
+bool checkOutputFiles(const Options& options)
+{
+    juce::Array<juce::File> outputs;
+    bool ok = true;
+
+    for (const auto& input : options.inputs)
+    {
+        const auto output = getOutputFile(input, options);
+        const int clash = outputs.indexOf(output);
+
+        if (options.inputs.contains(output))
+        {
+            std::fprintf(stderr, "%s would overwrite the input %s\n", input.getFullPathName().toRawUTF8(),
+                         output.getFullPathName().toRawUTF8());
+            ok = false;
+        }
+        else if (clash >= 0)
+        {
+            std::fprintf(stderr, "%s and %s would both be rendered to %s\n",
+                         options.inputs[clash].getFullPathName().toRawUTF8(), input.getFullPathName().toRawUTF8(),
+                         output.getFullPathName().toRawUTF8());
+            ok = false;
+        }
+
+        outputs.add(output);
+    }
+
+    return ok;
+}
+
+//==============================================================================
+FileResult renderFile(FlarksiesisAudioProcessor& processor, juce::AudioFormatManager& formats,
+                      const juce::File& input, const Options& options)
+{
+    FileResult result;
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input));
+
+    if (reader == nullptr)
+    {
+        result.message = "can't open as audio";
+        return result;
+    }
+
+    const int numChannels = static_cast<int>(reader->numChannels);
+
+    if (! flarksiesis::tools::setChannelCount(processor, numChannels))
+    {
+        result.message = juce::String(numChannels) + " channels are not supported";
+        return result;
+    }
+
+    const auto output = getOutputFile(input, options);
+    output.deleteFile();
+
+    auto stream = std::make_unique<juce::FileOutputStream>(output);
+    juce::WavAudioFormat wav;
+    const int bitsPerSample = reader->bitsPerSample == 16 || reader->bitsPerSample == 24 ? static_cast<int>(reader->bitsPerSample) : 32;
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+
+    if (stream->openedOk())
+        writer.reset(wav.createWriterFor(stream.get(), reader->sampleRate, static_cast<unsigned int>(numChannels),
+                                         bitsPerSample, {}, 0));
+
+    if (writer == nullptr)
+    {
+        result.message = "can't write " + output.getFullPathName();
+        return result;
+    }
+
+    stream.release(); // Now owned by the writer
+
+    const int blockSize = options.blockSize;
+    const flarksiesis::LoadMeter::ScopedReader loadReader(processor.getLoadMeter());
+    processor.prepareToPlay(reader->sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+
+    // Run past the end by the plugin's latency and drop that many samples from the start
+    const juce::int64 length = reader->lengthInSamples;
+    juce::int64 samplesToDrop = processor.getLatencySamples();
+    juce::int64 readPosition = 0, written = 0;
+    std::chrono::steady_clock::duration processTime {};
+
+    while (written < length)
+    {
+        buffer.clear();
+
+        if (readPosition < length)
+            reader->read(&buffer, 0, static_cast<int>(juce::jmin<juce::int64>(blockSize, length - readPosition)),
+                         readPosition, true, true);
+
+        readPosition += blockSize;
+
+        const auto start = std::chrono::steady_clock::now();
+        processor.processBlock(buffer, midi);
+        processTime += std::chrono::steady_clock::now() - start;
+
+        const int offset = static_cast<int>(juce::jmin<juce::int64>(samplesToDrop, blockSize));
+        const int count = static_cast<int>(juce::jmin<juce::int64>(blockSize - offset, length - written));
+        samplesToDrop -= offset;
+
+        if (count > 0 && ! writer->writeFromAudioSampleBuffer(buffer, offset, count))
+        {
+            result.message = "write failed for " + output.getFullPathName();
+            processor.releaseResources();
+            return result;
+        }
+
+        written += count;
+    }
+
+    result.load = processor.getLoadMeter().getStatistics();
+    processor.releaseResources();
+
+    result.ok = true;
+    result.frames = length;
+    result.channels = numChannels;
+    result.processSeconds = std::chrono::duration<double>(processTime).count();
+    result.message = output.getFullPathName();
+    return result;
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    // Parameters and timers need a message manager, even though no messages are dispatched
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Options options;
+
+    if (! parseArguments(argc, argv, options) || (options.inputs.isEmpty() && options.saveStateFile == juce::File()))
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (options.saveStateFile != juce::File())
+    {
+        FlarksiesisAudioProcessor processor;
+        juce::String error;
+        juce::MemoryBlock state;
+
+        if (! configure(processor, options, error))
+        {
+            std::fprintf(stderr, "%s\n", error.toRawUTF8());
+            return 1;
+        }
+
+        processor.getStateInformation(state);
+
+        if (! options.saveStateFile.replaceWithData(state.getData(), state.getSize()))
+        {
+            std::fprintf(stderr, "Can't write %s\n", options.saveStateFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        if (options.inputs.isEmpty())
+            return 0;
+    }
+
+    if (! checkOutputFiles(options))
+    {
+        std::fputs("Nothing rendered: use --out or --suffix to give every input its own output\n", stderr);
+        return 1;
+    }
+
+    if (options.outputDirectory != juce::File() && ! options.outputDirectory.createDirectory())
+    {
+        std::fprintf(stderr, "Can't create %s\n", options.outputDirectory.getFullPathName().toRawUTF8());
+        return 1;
+    }
+
+    const int numFiles = options.inputs.size();
+    const int hardwareThreads = juce::jmax(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const int numWorkers = juce::jlimit(1, numFiles, options.numJobs > 0 ? options.numJobs : hardwareThreads);
+
+    // One processor per worker, created here on the message thread
+    std::vector<std::unique_ptr<FlarksiesisAudioProcessor>> processors;
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        processors.push_back(std::make_unique<FlarksiesisAudioProcessor>());
+        juce::String error;
+
+        if (! configure(*processors.back(), options, error))
+        {
+            std::fprintf(stderr, "%s\n", error.toRawUTF8());
+            return 1;
+        }
+    }
+
+    std::vector<FileResult> results(static_cast<size_t>(numFiles));
+    std::atomic<int> nextFile {0};
+    std::vector<std::thread> workers;
+
+    const auto wallStart = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.emplace_back([&, i]
+        {
+            juce::AudioFormatManager formats;
+            formats.registerBasicFormats();
+
+            for (int index = nextFile++; index < numFiles; index = nextFile++)
+                results[static_cast<size_t>(index)] = renderFile(*processors[static_cast<size_t>(i)], formats,
+                                                                 options.inputs[index], options);
+        });
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+
+    const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    // Report
+    int failures = 0;
+    double totalFrames = 0.0, totalSamples = 0.0, totalProcessSeconds = 0.0;
+
+    for (int index = 0; index < numFiles; ++index)
+    {
+        const auto& result = results[static_cast<size_t>(index)];
+        const auto name = options.inputs[index].getFileName();
+
+        if (! result.ok)
+        {
+            std::fprintf(stderr, "FAILED %s: %s\n", name.toRawUTF8(), result.message.toRawUTF8());
+            ++failures;
+            continue;
+        }
+
+        totalFrames += static_cast<double>(result.frames);
+        totalSamples += static_cast<double>(result.frames) * result.channels;
+        totalProcessSeconds += result.processSeconds;
+
+        std::printf("%s -> %s (%.0f samples/s per core; block load mean %.2f%%, p99 %.0f%%, max %.2f%%)\n",
+                    name.toRawUTF8(), result.message.toRawUTF8(),
+                    result.processSeconds > 0.0 ? static_cast<double>(result.frames) * result.channels / result.processSeconds : 0.0,
+                    result.load.meanLoad * 100.0, result.load.p99Load * 100.0, result.load.maxLoad * 100.0);
+    }
+
+    if (totalProcessSeconds > 0.0)
+        std::printf("\n%d of %d files, %d workers, %.2f s wall clock\n"
+                    "throughput: %.0f samples/s per core (%.0f frames/s per core), %.0f samples/s overall\n",
+                    numFiles - failures, numFiles, numWorkers, wallSeconds,
+                    totalSamples / totalProcessSeconds, totalFrames / totalProcessSeconds,
+                    wallSeconds > 0.0 ? totalSamples / wallSeconds : 0.0);
+
+    return failures == 0 ? 0 : 2;
+}